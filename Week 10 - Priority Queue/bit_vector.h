@@ -0,0 +1,698 @@
+/***********************************************************************
+ * Header:
+ *    BIT VECTOR
+ * Summary:
+ *    A bit-packed vector of flags.  Each flag takes one bit of a
+ *    64-bit word instead of a whole byte, so a billion flags fit in
+ *    125MB, and the bulk operations work a word (64 flags) at a time:
+ *
+ *       custom::bit_vector<> visited(numNodes);
+ *       visited[n] = true;
+ *       size_t numVisited = visited.count();
+ *       for (size_t i = visited.find_first(); i < visited.size();
+ *            i = visited.find_next(i + 1))
+ *          ...
+ *
+ *    Like std::vector <bool>, operator[] hands back a proxy rather
+ *    than a bool &: it converts to bool and can be assigned to, but
+ *    its address is not the address of a bool.  That is why this is
+ *    a separate type you opt into rather than custom::vector <bool>,
+ *    which stays a plain array of bools that any container built on
+ *    vector can hand out references into.
+ *
+ *    This will contain the class definition of:
+ *        bit_vector             : A vector of flags, one bit each
+ *        bit_reference          : A writable reference to one bit
+ *        bit_iterator           : A random-access iterator through the bits
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <cstdint>  // for uint64_t
+#include <cstddef>  // for std::ptrdiff_t
+#include <cstring>  // for std::memcpy
+#include <iterator> // for std::random_access_iterator_tag
+#include <memory>   // for std::allocator_traits
+#include <type_traits>     // for std::enable_if
+#include <initializer_list>
+#include "vector.h"
+
+class TestBitVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * BITS
+ * Word-level helpers.  Bit i lives in word i / 64
+ * at position i % 64
+ ****************************************/
+struct bits
+{
+   typedef uint64_t word;
+   static const size_t perWord = 64;
+
+   static size_t wordsFor(size_t numBits) { return (numBits + perWord - 1) / perWord; }
+   static size_t wordOf(size_t bit)       { return bit / perWord; }
+   static word   maskOf(size_t bit)       { return word(1) << (bit % perWord); }
+
+   // how many bits of w are set
+   static size_t popcount(word w)
+   {
+#if defined(__GNUC__)
+      return (size_t)__builtin_popcountll(w);
+#else
+      w = w - ((w >> 1) & 0x5555555555555555ull);
+      w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+      w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+      return (size_t)((w * 0x0101010101010101ull) >> 56);
+#endif
+   }
+
+   // position of the lowest set bit: w != 0
+   static size_t lowBit(word w)
+   {
+      assert(w != 0);
+#if defined(__GNUC__)
+      return (size_t)__builtin_ctzll(w);
+#else
+      size_t bit = 0;
+      while (!(w & 1))
+      {
+         w >>= 1;
+         bit++;
+      }
+      return bit;
+#endif
+   }
+};
+
+/*****************************************
+ * BIT REFERENCE
+ * Stands in for a bool & to one bit of a word
+ ****************************************/
+class bit_reference
+{
+public:
+   bit_reference(bits::word * words, size_t bit) :
+      pWord(words + bits::wordOf(bit)), mask(bits::maskOf(bit)) { }
+
+   operator bool () const { return (*pWord & mask) != 0; }
+   bool operator ~ () const { return !(*pWord & mask); }
+   bit_reference & operator = (bool b)
+   {
+      if (b)
+         *pWord |= mask;
+      else
+         *pWord &= ~mask;
+      return *this;
+   }
+   bit_reference & operator = (const bit_reference & rhs) { return *this = bool(rhs); }
+   void flip() { *pWord ^= mask; }
+
+   friend void swap(bit_reference lhs, bit_reference rhs) noexcept
+   {
+      bool b = lhs;
+      lhs = bool(rhs);
+      rhs = b;
+   }
+
+private:
+   bits::word * pWord;   // the word holding our bit
+   bits::word   mask;    // which bit of it
+};
+
+// bit i of words: writable if words is, a plain bool if not
+inline bit_reference bitAt(bits::word * words, size_t bit)       { return bit_reference(words, bit); }
+inline bool          bitAt(const bits::word * words, size_t bit) { return (words[bits::wordOf(bit)] & bits::maskOf(bit)) != 0; }
+
+/**************************************************
+ * BIT ITERATOR
+ * A random-access iterator through the bits: the
+ * start of the words and an index into them.  W is
+ * bits::word for iterator, const bits::word for
+ * const_iterator
+ *************************************************/
+template <class W>
+class bit_iterator
+{
+   template <class WW>
+   friend class bit_iterator;
+public:
+   typedef std::random_access_iterator_tag          iterator_category;
+   typedef bool                                     value_type;
+   typedef std::ptrdiff_t                           difference_type;
+   typedef decltype(bitAt((W *)nullptr, 0))         reference;
+   typedef void                                     pointer;
+
+   bit_iterator() : words(nullptr), index(0) { }
+   bit_iterator(W * words, size_t index) : words(words), index(index) { }
+
+   // an iterator converts to a const_iterator, never the other way
+   template <class WW, class = typename std::enable_if<
+      std::is_convertible<WW *, W *>::value>::type>
+   bit_iterator(const bit_iterator<WW> & rhs) : words(rhs.words), index(rhs.index) { }
+
+   // compare
+   friend bool operator == (const bit_iterator & lhs, const bit_iterator & rhs) { return lhs.index == rhs.index; }
+   friend bool operator != (const bit_iterator & lhs, const bit_iterator & rhs) { return lhs.index != rhs.index; }
+   friend bool operator <  (const bit_iterator & lhs, const bit_iterator & rhs) { return lhs.index <  rhs.index; }
+   friend bool operator >  (const bit_iterator & lhs, const bit_iterator & rhs) { return lhs.index >  rhs.index; }
+   friend bool operator <= (const bit_iterator & lhs, const bit_iterator & rhs) { return lhs.index <= rhs.index; }
+   friend bool operator >= (const bit_iterator & lhs, const bit_iterator & rhs) { return lhs.index >= rhs.index; }
+
+   // dereference
+   reference operator * () const                   { return bitAt(words, index); }
+   reference operator [] (difference_type n) const { return bitAt(words, index + n); }
+
+   // walk
+   bit_iterator & operator ++ ()    { ++index; return *this; }
+   bit_iterator   operator ++ (int) { bit_iterator tmp(*this); ++index; return tmp; }
+   bit_iterator & operator -- ()    { --index; return *this; }
+   bit_iterator   operator -- (int) { bit_iterator tmp(*this); --index; return tmp; }
+   bit_iterator & operator += (difference_type n) { index += n; return *this; }
+   bit_iterator & operator -= (difference_type n) { index -= n; return *this; }
+
+   friend bit_iterator operator + (bit_iterator it, difference_type n) { return it += n; }
+   friend bit_iterator operator + (difference_type n, bit_iterator it) { return it += n; }
+   friend bit_iterator operator - (bit_iterator it, difference_type n) { return it -= n; }
+   friend difference_type operator - (const bit_iterator & lhs, const bit_iterator & rhs)
+   {
+      return (difference_type)lhs.index - (difference_type)rhs.index;
+   }
+
+private:
+   W * words;       // the start of the vector's words
+   size_t index;    // which bit we are on
+};
+
+/*****************************************
+ * BIT VECTOR
+ * Bits [0, numElements) are live.  Every other bit
+ * of the buffer, up to capacity(), is kept zero: that
+ * lets count, find and the word-wide operators work
+ * on whole words without masking off the tail
+ ****************************************/
+template <typename A = std::allocator<bool>, typename G = growth_doubling>
+class bit_vector
+{
+   friend class ::TestBitVector; // give unit tests access to the privates
+public:
+
+   typedef bool value_type;
+   typedef A allocator_type;
+   typedef bit_reference reference;
+   typedef bool const_reference;
+
+   //
+   // Construct
+   //
+
+   bit_vector(const A & a = A()) : alloc(a), data(nullptr), numWords(0), numElements(0) { }
+   bit_vector(size_t numElements,                   const A & a = A());
+   bit_vector(size_t numElements, bool b,           const A & a = A());
+   bit_vector(const std::initializer_list<bool> & l, const A & a = A());
+   bit_vector(const bit_vector &  rhs);
+   bit_vector(      bit_vector && rhs) noexcept;
+   ~bit_vector() { deallocate(data, numWords); }
+
+   //
+   // Assign
+   //
+
+   void swap(bit_vector & rhs) noexcept
+   {
+      if (traits::propagate_on_container_swap::value)
+         std::swap(alloc, rhs.alloc);
+      std::swap(data, rhs.data);
+      std::swap(numWords, rhs.numWords);
+      std::swap(numElements, rhs.numElements);
+   }
+   bit_vector & operator = (const bit_vector & rhs);
+   bit_vector & operator = (bit_vector && rhs)
+      noexcept(traits::propagate_on_container_move_assignment::value ||
+               traits::is_always_equal::value);
+
+   //
+   // Iterator
+   //
+
+   typedef bit_iterator <bits::word>              iterator;
+   typedef bit_iterator <const bits::word>        const_iterator;
+   typedef std::reverse_iterator <iterator>       reverse_iterator;
+   typedef std::reverse_iterator <const_iterator> const_reverse_iterator;
+
+   iterator       begin()        { return iterator(data, 0); }
+   iterator       end()          { return iterator(data, numElements); }
+   const_iterator begin()  const { return const_iterator(data, 0); }
+   const_iterator end()    const { return const_iterator(data, numElements); }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end(); }
+   reverse_iterator       rbegin()        { return reverse_iterator(end()); }
+   reverse_iterator       rend()          { return reverse_iterator(begin()); }
+   const_reverse_iterator rbegin()  const { return const_reverse_iterator(end()); }
+   const_reverse_iterator rend()    const { return const_reverse_iterator(begin()); }
+   const_reverse_iterator crbegin() const { return rbegin(); }
+   const_reverse_iterator crend()   const { return rend(); }
+
+   //
+   // Access
+   //
+
+   reference operator [] (size_t index)       { return bitAt(data, index); }
+   bool      operator [] (size_t index) const { return bitAt((const bits::word *)data, index); }
+   reference front()       { return (*this)[0]; }
+   bool      front() const { return (*this)[0]; }
+   reference back()        { return (*this)[numElements - 1]; }
+   bool      back()  const { return (*this)[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(bool b);
+   reference emplace_back(bool b) { push_back(b); return back(); }
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements) { resize(newElements, false); }
+   void resize(size_t newElements, bool b);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      zero(0, bits::wordsFor(numElements));
+      numElements = 0;
+   }
+   void pop_back()
+   {
+      if (numElements > 0)
+         (*this)[--numElements] = false;
+   }
+   void shrink_to_fit();
+
+   //
+   // Word-wide operations: 64 flags at a time
+   //
+
+   size_t count() const;                  // how many flags are set
+   size_t find_first() const { return find_next(0); }
+   size_t find_next(size_t pos) const;    // first set flag at or after pos, else size()
+   void flip();                           // invert every flag
+   bit_vector & operator &= (const bit_vector & rhs);
+   bit_vector & operator |= (const bit_vector & rhs);
+   bit_vector & operator ^= (const bit_vector & rhs);
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements; }
+   size_t capacity() const { return numWords * bits::perWord; }
+   bool   empty()    const { return numElements == 0; }
+   A get_allocator() const { return A(alloc); }
+
+   // bytes of words held from the allocator, and how many are in use
+   struct memory
+   {
+      size_t reserved;
+      size_t used;
+   };
+   memory memory_usage() const
+   {
+      return { numWords * sizeof(bits::word), bits::wordsFor(numElements) * sizeof(bits::word) };
+   }
+
+private:
+
+   // the storage is words, whatever A was asked to hold
+   typedef typename std::allocator_traits<A>::template rebind_alloc<bits::word> word_allocator;
+   typedef std::allocator_traits<word_allocator> traits;
+
+   bits::word * allocate(size_t num);
+   void deallocate(bits::word * p, size_t num);
+   void zero(size_t begin, size_t end) { if (end > begin) std::memset(data + begin, 0, (end - begin) * sizeof(bits::word)); }
+   void reallocate(size_t newWords);
+   void clearTail();
+
+   word_allocator alloc;       // hands out the words
+   bits::word *   data;        // the flags, 64 to a word
+   size_t         numWords;    // the capacity of the array, in words
+   size_t         numElements; // the number of flags currently used
+};
+
+/*****************************************
+ * BIT VECTOR :: NON-DEFAULT constructors
+ * num flags, all false or all b
+ ****************************************/
+template <typename A, typename G>
+bit_vector <A, G> :: bit_vector(size_t num, const A & a) :
+   alloc(a), data(nullptr), numWords(0), numElements(0)
+{
+   resize(num, false);
+}
+
+template <typename A, typename G>
+bit_vector <A, G> :: bit_vector(size_t num, bool b, const A & a) :
+   alloc(a), data(nullptr), numWords(0), numElements(0)
+{
+   resize(num, b);
+}
+
+/*****************************************
+ * BIT VECTOR :: INITIALIZATION LIST constructor
+ ****************************************/
+template <typename A, typename G>
+bit_vector <A, G> :: bit_vector(const std::initializer_list<bool> & l, const A & a) :
+   alloc(a), data(nullptr), numWords(0), numElements(0)
+{
+   reserve(l.size());
+   for (bool b : l)
+      push_back(b);
+}
+
+/*****************************************
+ * BIT VECTOR :: COPY CONSTRUCTOR
+ * One memcpy of the words in use
+ ****************************************/
+template <typename A, typename G>
+bit_vector <A, G> :: bit_vector(const bit_vector & rhs) :
+   alloc(traits::select_on_container_copy_construction(rhs.alloc)),
+   data(nullptr), numWords(0), numElements(0)
+{
+   numWords = bits::wordsFor(rhs.numElements);
+   data = allocate(numWords);
+   if (numWords)
+      std::memcpy(data, rhs.data, numWords * sizeof(bits::word));
+   numElements = rhs.numElements;
+}
+
+/*****************************************
+ * BIT VECTOR :: MOVE CONSTRUCTOR
+ ****************************************/
+template <typename A, typename G>
+bit_vector <A, G> :: bit_vector(bit_vector && rhs) noexcept :
+   alloc(std::move(rhs.alloc)), data(rhs.data),
+   numWords(rhs.numWords), numElements(rhs.numElements)
+{
+   rhs.data = nullptr;
+   rhs.numWords = 0;
+   rhs.numElements = 0;
+}
+
+/***************************************
+ * BIT VECTOR :: ASSIGNMENT
+ * Copy the words of rhs, keeping our buffer when it
+ * is big enough
+ *     INPUT  : rhs the vector to copy from
+ *     OUTPUT : *this
+ **************************************/
+template <typename A, typename G>
+bit_vector <A, G> & bit_vector <A, G> :: operator = (const bit_vector & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   // our allocator is about to be replaced: free with the old one first
+   if (traits::propagate_on_container_copy_assignment::value && !(alloc == rhs.alloc))
+   {
+      deallocate(data, numWords);
+      data = nullptr;
+      numWords = 0;
+      alloc = rhs.alloc;
+   }
+
+   size_t wordsUsed = bits::wordsFor(rhs.numElements);
+   if (wordsUsed > numWords)
+   {
+      bits::word * newData = allocate(wordsUsed);
+      deallocate(data, numWords);
+      data = newData;
+      numWords = wordsUsed;
+   }
+   if (wordsUsed)
+      std::memcpy(data, rhs.data, wordsUsed * sizeof(bits::word));
+   zero(wordsUsed, bits::wordsFor(numElements));
+   numElements = rhs.numElements;
+   return *this;
+}
+
+template <typename A, typename G>
+bit_vector <A, G> & bit_vector <A, G> :: operator = (bit_vector && rhs)
+   noexcept(traits::propagate_on_container_move_assignment::value ||
+            traits::is_always_equal::value)
+{
+   if (this == &rhs)
+      return *this;
+
+   // an allocator that stays behind and cannot free rhs's words
+   if (!traits::propagate_on_container_move_assignment::value && !(alloc == rhs.alloc))
+   {
+      *this = static_cast<const bit_vector &>(rhs);
+      rhs.clear();
+      return *this;
+   }
+
+   deallocate(data, numWords);
+   if (traits::propagate_on_container_move_assignment::value)
+      alloc = std::move(rhs.alloc);
+   data = rhs.data;
+   numWords = rhs.numWords;
+   numElements = rhs.numElements;
+   rhs.data = nullptr;
+   rhs.numWords = 0;
+   rhs.numElements = 0;
+   return *this;
+}
+
+/***************************************
+ * BIT VECTOR :: PUSH BACK
+ * The bit past the end is already zero, so only a
+ * true has anything to write
+ *     INPUT  : b the new flag
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: push_back(bool b)
+{
+   if (numElements == capacity())
+      reallocate(G::grow(numWords, numWords + 1, sizeof(bits::word)));
+   if (b)
+      data[bits::wordOf(numElements)] |= bits::maskOf(numElements);
+   ++numElements;
+}
+
+/***************************************
+ * BIT VECTOR :: RESERVE
+ *     INPUT  : newCapacity in flags
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: reserve(size_t newCapacity)
+{
+   if (newCapacity > capacity())
+      reallocate(bits::wordsFor(newCapacity));
+}
+
+/***************************************
+ * BIT VECTOR :: RESIZE
+ * Growing with true fills whole words at a time;
+ * shrinking zeroes the flags given up
+ *     INPUT  : newElements the new size
+ *              b the value of any new flags
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: resize(size_t newElements, bool b)
+{
+   if (newElements <= numElements)
+   {
+      size_t oldElements = numElements;
+      numElements = newElements;
+      clearTail();
+      zero(bits::wordsFor(newElements), bits::wordsFor(oldElements));
+      return;
+   }
+
+   if (newElements > capacity())
+      reallocate(bits::wordsFor(newElements));
+
+   if (b)
+   {
+      // finish the partly used word, then whole words of ones
+      size_t i = numElements;
+      for (; i < newElements && i % bits::perWord; ++i)
+         data[bits::wordOf(i)] |= bits::maskOf(i);
+      if (i < newElements)
+         std::memset(data + bits::wordOf(i), 0xff,
+                     (bits::wordsFor(newElements) - bits::wordOf(i)) * sizeof(bits::word));
+   }
+   numElements = newElements;
+   clearTail();
+}
+
+/***************************************
+ * BIT VECTOR :: SHRINK TO FIT
+ * Give back the words past the last one in use
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: shrink_to_fit()
+{
+   size_t wordsUsed = bits::wordsFor(numElements);
+   if (wordsUsed < numWords)
+      reallocate(wordsUsed);
+}
+
+/***************************************
+ * BIT VECTOR :: COUNT
+ * One popcount per word
+ *     OUTPUT : the number of flags that are set
+ **************************************/
+template <typename A, typename G>
+size_t bit_vector <A, G> :: count() const
+{
+   size_t num = 0;
+   size_t wordsUsed = bits::wordsFor(numElements);
+   for (size_t w = 0; w < wordsUsed; w++)
+      num += bits::popcount(data[w]);
+   return num;
+}
+
+/***************************************
+ * BIT VECTOR :: FIND NEXT
+ * Skip clear words whole, then take the lowest set
+ * bit of the first word that has one
+ *     INPUT  : pos where to start looking
+ *     OUTPUT : the index of the first set flag at or
+ *              after pos, or size() if there is none
+ **************************************/
+template <typename A, typename G>
+size_t bit_vector <A, G> :: find_next(size_t pos) const
+{
+   if (pos >= numElements)
+      return numElements;
+
+   size_t wordsUsed = bits::wordsFor(numElements);
+   size_t w = bits::wordOf(pos);
+   bits::word current = data[w] & (~bits::word(0) << (pos % bits::perWord));
+   while (current == 0)
+   {
+      if (++w == wordsUsed)
+         return numElements;
+      current = data[w];
+   }
+   return w * bits::perWord + bits::lowBit(current);
+}
+
+/***************************************
+ * BIT VECTOR :: FLIP
+ * Invert every word, then put the tail back to zero
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: flip()
+{
+   size_t wordsUsed = bits::wordsFor(numElements);
+   for (size_t w = 0; w < wordsUsed; w++)
+      data[w] = ~data[w];
+   clearTail();
+}
+
+/***************************************
+ * BIT VECTOR :: AND, OR, XOR
+ * Combine with a vector of the same size, a word
+ * at a time.  Zero tails stay zero
+ *     INPUT  : rhs, the same size as *this
+ *     OUTPUT : *this
+ **************************************/
+template <typename A, typename G>
+bit_vector <A, G> & bit_vector <A, G> :: operator &= (const bit_vector & rhs)
+{
+   assert(numElements == rhs.numElements);
+   size_t wordsUsed = bits::wordsFor(numElements);
+   for (size_t w = 0; w < wordsUsed; w++)
+      data[w] &= rhs.data[w];
+   return *this;
+}
+
+template <typename A, typename G>
+bit_vector <A, G> & bit_vector <A, G> :: operator |= (const bit_vector & rhs)
+{
+   assert(numElements == rhs.numElements);
+   size_t wordsUsed = bits::wordsFor(numElements);
+   for (size_t w = 0; w < wordsUsed; w++)
+      data[w] |= rhs.data[w];
+   return *this;
+}
+
+template <typename A, typename G>
+bit_vector <A, G> & bit_vector <A, G> :: operator ^= (const bit_vector & rhs)
+{
+   assert(numElements == rhs.numElements);
+   size_t wordsUsed = bits::wordsFor(numElements);
+   for (size_t w = 0; w < wordsUsed; w++)
+      data[w] ^= rhs.data[w];
+   return *this;
+}
+
+/***************************************
+ * BIT VECTOR :: ALLOCATE
+ * num words, all zero; nullptr for none
+ **************************************/
+template <typename A, typename G>
+bits::word * bit_vector <A, G> :: allocate(size_t num)
+{
+   if (num == 0)
+      return nullptr;
+   bits::word * p = traits::allocate(alloc, num);
+   std::memset(p, 0, num * sizeof(bits::word));
+   return p;
+}
+
+template <typename A, typename G>
+void bit_vector <A, G> :: deallocate(bits::word * p, size_t num)
+{
+   if (p != nullptr)
+      traits::deallocate(alloc, p, num);
+}
+
+/***************************************
+ * BIT VECTOR :: REALLOCATE
+ * Copy the words in use into a fresh, zeroed
+ * buffer of newWords
+ *     INPUT  : newWords >= the words in use
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: reallocate(size_t newWords)
+{
+   size_t wordsUsed = bits::wordsFor(numElements);
+   assert(newWords >= wordsUsed);
+   bits::word * newData = allocate(newWords);
+   if (wordsUsed)
+      std::memcpy(newData, data, wordsUsed * sizeof(bits::word));
+   deallocate(data, numWords);
+   data = newData;
+   numWords = newWords;
+}
+
+/***************************************
+ * BIT VECTOR :: CLEAR TAIL
+ * Zero the bits of the last word in use that lie
+ * past numElements
+ **************************************/
+template <typename A, typename G>
+void bit_vector <A, G> :: clearTail()
+{
+   size_t used = numElements % bits::perWord;
+   if (used)
+      data[bits::wordOf(numElements)] &= (bits::word(1) << used) - 1;
+}
+
+/*****************************************
+ * SWAP
+ ****************************************/
+template <typename A, typename G>
+void swap(bit_vector <A, G> & lhs, bit_vector <A, G> & rhs) noexcept
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
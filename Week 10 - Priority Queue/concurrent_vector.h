@@ -0,0 +1,265 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT VECTOR
+ * Summary:
+ *    An append-only vector that many threads can push onto at once
+ *    without a lock:
+ *
+ *       custom::concurrent_vector<Record> v;
+ *       // any thread:
+ *       size_t i = v.push_back(record);
+ *
+ *    Each push claims its slot with one compare-exchange, so producers
+ *    never wait on each other.  Storage is the same doubling blocks as
+ *    stable_vector: nothing ever moves, so once a push_back has
+ *    returned, element i may be read from any thread that has been
+ *    told about i (through a queue, a join, an atomic, ...) even while
+ *    others keep appending.
+ *
+ *    size() counts claimed slots, which may include elements another
+ *    thread is still building.  Only read indices you were handed.
+ *
+ *    This will contain the class definition of:
+ *        concurrent_vector      : A lock-free, append-only segmented vector
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for size_t
+#include <memory>   // for std::allocator
+#include <type_traits> // for std::is_nothrow_constructible
+#include <utility>  // for std::forward
+#include "stable_vector.h" // for segment
+
+class TestConcurrentVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * CONCURRENT VECTOR
+ * numClaimed hands out indices.  The block table is
+ * atomic: the first thread to need a block allocates
+ * it and installs it with a compare-exchange; a thread
+ * that loses the race frees its block and uses the
+ * winner's, so A must be safe to call from several
+ * threads (std::allocator is).
+ *
+ * A slot cannot be given back once claimed, so all
+ * that can throw happens first: the blocks are
+ * allocated before the indices are claimed, and
+ * push_back and emplace_back build the element
+ * before claiming when T's constructor can throw but
+ * its move cannot.  Only grow_by, or a T whose move
+ * can throw, still builds into a claimed slot; a
+ * constructor that throws there ends the program
+ * rather than leaving a hole
+ ****************************************/
+template <typename T, typename A = std::allocator<T>>
+class concurrent_vector
+{
+   friend class ::TestConcurrentVector; // give unit tests access to the privates
+public:
+   typedef T value_type;
+   typedef A allocator_type;
+
+   //
+   // Construct
+   //
+
+   concurrent_vector(const A & a = A());
+   concurrent_vector(const concurrent_vector & rhs) = delete;
+   concurrent_vector & operator = (const concurrent_vector & rhs) = delete;
+   ~concurrent_vector();
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return *slot(index); }
+   const T & operator [] (size_t index) const { return *slot(index); }
+
+   //
+   // Insert: safe from any number of threads at once.
+   // Each returns the index of the (first) new element
+   //
+
+   size_t push_back(const T & t) { return emplace_back(t);            }
+   size_t push_back(T && t)      { return emplace_back(std::move(t)); }
+   template <class ... Args>
+   size_t emplace_back(Args && ... args);
+   size_t grow_by(size_t num);
+   size_t grow_by(size_t num, const T & t);
+
+   //
+   // Status
+   //
+
+   size_t size()  const { return numClaimed.load(std::memory_order_acquire); }
+   bool   empty() const { return size() == 0; }
+
+private:
+   typedef std::allocator_traits<A> traits;
+
+   T * slot(size_t index) const
+   {
+      T * block = blocks[segment::block(index)].load(std::memory_order_acquire);
+      assert(block != nullptr);
+      return block + segment::offset(index);
+   }
+   template <class ... Args>
+   void build(size_t index, Args && ... args) noexcept
+   {
+      traits::construct(alloc, slot(index), std::forward<Args>(args)...);
+   }
+   template <class ... Args>
+   size_t emplaceBack(std::false_type, Args && ... args);
+   template <class ... Args>
+   size_t emplaceBack(std::true_type, Args && ... args);
+   void allocateBlocks(size_t first, size_t last);
+   size_t claim(size_t num);
+
+   A alloc;                                         // hands out the blocks
+   std::atomic<T *> blocks[segment::maxBlocks];     // installed once, never moved
+   std::atomic<size_t> numClaimed;                  // indices handed out so far
+};
+
+/*****************************************
+ * CONCURRENT VECTOR :: DEFAULT constructor
+ * No blocks until the first push
+ ****************************************/
+template <typename T, typename A>
+concurrent_vector <T, A> :: concurrent_vector(const A & a) : alloc(a), numClaimed(0)
+{
+   for (size_t k = 0; k < segment::maxBlocks; k++)
+      blocks[k].store(nullptr, std::memory_order_relaxed);
+}
+
+/*****************************************
+ * CONCURRENT VECTOR :: DESTRUCTOR
+ * Not thread-safe: every producer must be done
+ ****************************************/
+template <typename T, typename A>
+concurrent_vector <T, A> :: ~concurrent_vector()
+{
+   size_t num = numClaimed.load(std::memory_order_acquire);
+   for (size_t i = 0; i < num; i++)
+      traits::destroy(alloc, slot(i));
+   for (size_t k = 0; k < segment::maxBlocks; k++)
+   {
+      T * block = blocks[k].load(std::memory_order_relaxed);
+      if (block)
+         traits::deallocate(alloc, block, segment::blockSize(k));
+   }
+}
+
+/***************************************
+ * CONCURRENT VECTOR :: EMPLACE BACK
+ * Claim one index and build the element there.
+ * If building can throw, build it before claiming
+ * and move it in, so a throw leaves no hole
+ *     INPUT  : args for one of T's constructors
+ *     OUTPUT : the index of the new element
+ **************************************/
+template <typename T, typename A>
+template <class ... Args>
+size_t concurrent_vector <T, A> :: emplace_back(Args && ... args)
+{
+   typedef std::integral_constant<bool,
+      !std::is_nothrow_constructible<T, Args && ...>::value &&
+      std::is_nothrow_move_constructible<T>::value> buildFirst;
+   return emplaceBack(buildFirst(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename A>
+template <class ... Args>
+size_t concurrent_vector <T, A> :: emplaceBack(std::false_type, Args && ... args)
+{
+   size_t index = claim(1);
+   build(index, std::forward<Args>(args)...);
+   return index;
+}
+
+template <typename T, typename A>
+template <class ... Args>
+size_t concurrent_vector <T, A> :: emplaceBack(std::true_type, Args && ... args)
+{
+   T t(std::forward<Args>(args)...);
+   size_t index = claim(1);
+   build(index, std::move(t));
+   return index;
+}
+
+/***************************************
+ * CONCURRENT VECTOR :: GROW BY
+ * Claim num consecutive indices with one compare-
+ * exchange and build each element: value-initialized,
+ * or a copy of t
+ *     OUTPUT : the index of the first new element
+ **************************************/
+template <typename T, typename A>
+size_t concurrent_vector <T, A> :: grow_by(size_t num)
+{
+   size_t first = claim(num);
+   for (size_t i = first; i < first + num; i++)
+      build(i);
+   return first;
+}
+
+template <typename T, typename A>
+size_t concurrent_vector <T, A> :: grow_by(size_t num, const T & t)
+{
+   size_t first = claim(num);
+   for (size_t i = first; i < first + num; i++)
+      build(i, t);
+   return first;
+}
+
+/***************************************
+ * CONCURRENT VECTOR :: CLAIM
+ * Reserve num indices for the calling thread.  The
+ * blocks they need are allocated first, so if that
+ * throws nothing has been claimed.  Losing the race
+ * to another thread just means trying the next ones
+ *     OUTPUT : the first of them
+ **************************************/
+template <typename T, typename A>
+size_t concurrent_vector <T, A> :: claim(size_t num)
+{
+   size_t first = numClaimed.load(std::memory_order_acquire);
+   do
+      allocateBlocks(first, first + num);
+   while (!numClaimed.compare_exchange_weak(first, first + num,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire));
+   return first;
+}
+
+/***************************************
+ * CONCURRENT VECTOR :: ALLOCATE BLOCKS
+ * Make sure every block holding [first, last) is
+ * installed.  Racing threads each allocate; one
+ * compare-exchange wins and the rest free theirs
+ *     INPUT  : the indices about to be claimed
+ **************************************/
+template <typename T, typename A>
+void concurrent_vector <T, A> :: allocateBlocks(size_t first, size_t last)
+{
+   if (first == last)
+      return;
+   for (size_t k = segment::block(first); k <= segment::block(last - 1); k++)
+   {
+      T * block = blocks[k].load(std::memory_order_acquire);
+      if (block != nullptr)
+         continue;
+      T * fresh = traits::allocate(alloc, segment::blockSize(k));
+      if (!blocks[k].compare_exchange_strong(block, fresh,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire))
+         traits::deallocate(alloc, fresh, segment::blockSize(k));
+   }
+}
+
+} // namespace custom
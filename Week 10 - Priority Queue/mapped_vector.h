@@ -0,0 +1,528 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED VECTOR
+ * Summary:
+ *    A vector of plain records that lives in a memory-mapped file.
+ *    Opening the file again hands back the same elements without
+ *    parsing or copying anything:
+ *
+ *       custom::mapped_vector<Record> table("records.bin");
+ *       if (table.empty())
+ *          ... build it once ...
+ *
+ *    The file starts with a small header (magic, version, element
+ *    size, count) so a file written for a different T is refused.
+ *
+ *    This will contain the class definition of:
+ *        mapped_vector          : A file-backed vector of trivially copyable T
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t and uint64_t
+#include <stdexcept>   // for std::runtime_error
+#include <type_traits> // for std::is_trivially_copyable
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class TestMappedVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * MAPPED VECTOR
+ * The elements are the bytes of the file, so T
+ * must be trivially copyable.  Capacity is whatever
+ * the file has room for; push_back doubles the file
+ * when it runs out, and closing trims it to size
+ ****************************************/
+template <typename T>
+class mapped_vector
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "mapped_vector<T> needs a trivially copyable T");
+   friend class ::TestMappedVector; // give unit tests access to the privates
+public:
+   typedef T value_type;
+   typedef T * iterator;
+
+   static const uint32_t magic   = 0x52564D43; // "CMVR"
+   static const uint32_t version = 1;
+
+   //
+   // Construct
+   //
+
+   explicit mapped_vector(const char * path);
+   mapped_vector(mapped_vector && rhs);
+   mapped_vector(const mapped_vector & rhs) = delete;
+   ~mapped_vector() { close(); }
+
+   mapped_vector & operator = (mapped_vector && rhs);
+   mapped_vector & operator = (const mapped_vector & rhs) = delete;
+
+   //
+   // Iterator
+   //
+
+   iterator begin() { return data; }
+   iterator end()   { return data + size(); }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return data[index]; }
+   const T & operator [] (size_t index) const { return data[index]; }
+         T & front()       { return data[0]; }
+   const T & front() const { return data[0]; }
+         T & back()        { return data[size() - 1]; }
+   const T & back()  const { return data[size() - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t);
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements);
+
+   //
+   // Remove
+   //
+
+   void pop_back() { if (!empty()) --header->count; }
+   void clear()    { if (header) header->count = 0; }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return header ? (size_t)header->count : 0; }
+   size_t capacity() const { return numCapacity; }
+   bool   empty()    const { return size() == 0; }
+
+   void flush();
+
+private:
+   // what sits at the front of the file
+   struct Header
+   {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t elementSize;
+      uint32_t reserved;
+      uint64_t count;
+   };
+
+   // the elements start here, leaving room for any alignment of T
+   static const size_t dataOffset = 64;
+   static_assert(sizeof(Header) <= dataOffset && alignof(T) <= dataOffset,
+                 "mapped_vector<T> header does not leave room for T");
+
+   static size_t fileBytes(size_t num) { return dataOffset + num * sizeof(T); }
+
+   void remap(size_t newCapacity);
+   void close();
+
+   // platform
+   size_t openFile(const char * path);
+   void resizeFile(size_t bytes);
+   void mapFile(size_t bytes);
+   void unmapFile();
+   void closeFile();
+
+   Header * header;           // the start of the mapping
+   T *  data;                 // the elements, dataOffset past the header
+   size_t  numCapacity;       // how many elements the file has room for
+#ifdef _WIN32
+   HANDLE file;
+   HANDLE mapping;
+#else
+   int fd;
+#endif
+};
+
+/***************************************
+ * MAPPED VECTOR :: CONSTRUCTOR
+ * Open path, or create it if it is not there.
+ * An existing file is mapped as-is: no elements
+ * are read or copied
+ *     INPUT  : path of the backing file
+ **************************************/
+template <typename T>
+mapped_vector <T> :: mapped_vector(const char * path) :
+   header(nullptr), data(nullptr), numCapacity(0)
+{
+   size_t bytes = openFile(path);
+
+   if (bytes == 0)
+   {
+      // brand new file: write the header
+      try
+      {
+         resizeFile(fileBytes(0));
+         mapFile(fileBytes(0));
+      }
+      catch (...)
+      {
+         closeFile();
+         throw;
+      }
+      header->magic = magic;
+      header->version = version;
+      header->elementSize = (uint32_t)sizeof(T);
+      header->reserved = 0;
+      header->count = 0;
+      return;
+   }
+
+   if (bytes < dataOffset)
+   {
+      closeFile();
+      throw std::runtime_error("mapped_vector: file is too small");
+   }
+
+   numCapacity = (bytes - dataOffset) / sizeof(T);
+   try
+   {
+      mapFile(fileBytes(numCapacity));
+   }
+   catch (...)
+   {
+      closeFile();
+      throw;
+   }
+
+   if (header->magic != magic ||
+       header->version != version ||
+       header->elementSize != sizeof(T) ||
+       header->count > numCapacity)
+   {
+      unmapFile();
+      closeFile();
+      throw std::runtime_error("mapped_vector: file does not hold this type");
+   }
+}
+
+/***************************************
+ * MAPPED VECTOR :: MOVE CONSTRUCTOR
+ * Take over rhs's file and mapping
+ **************************************/
+template <typename T>
+mapped_vector <T> :: mapped_vector(mapped_vector && rhs) :
+   header(rhs.header), data(rhs.data), numCapacity(rhs.numCapacity)
+#ifdef _WIN32
+   , file(rhs.file), mapping(rhs.mapping)
+#else
+   , fd(rhs.fd)
+#endif
+{
+   rhs.header = nullptr;
+   rhs.data = nullptr;
+   rhs.numCapacity = 0;
+#ifdef _WIN32
+   rhs.file = INVALID_HANDLE_VALUE;
+   rhs.mapping = nullptr;
+#else
+   rhs.fd = -1;
+#endif
+}
+
+/***************************************
+ * MAPPED VECTOR :: MOVE ASSIGNMENT
+ * Close our file, then take over rhs's
+ **************************************/
+template <typename T>
+mapped_vector <T> & mapped_vector <T> :: operator = (mapped_vector && rhs)
+{
+   if (this != &rhs)
+   {
+      close();
+      header = rhs.header;
+      data = rhs.data;
+      numCapacity = rhs.numCapacity;
+      rhs.header = nullptr;
+      rhs.data = nullptr;
+      rhs.numCapacity = 0;
+#ifdef _WIN32
+      file = rhs.file;
+      mapping = rhs.mapping;
+      rhs.file = INVALID_HANDLE_VALUE;
+      rhs.mapping = nullptr;
+#else
+      fd = rhs.fd;
+      rhs.fd = -1;
+#endif
+   }
+   return *this;
+}
+
+/***************************************
+ * MAPPED VECTOR :: PUSH BACK
+ * Append an element, doubling the file if full
+ *     INPUT  : the element to append
+ **************************************/
+template <typename T>
+void mapped_vector <T> :: push_back(const T & t)
+{
+   if (size() == numCapacity)
+   {
+      T copy = t;   // t may live in the mapping we are about to move
+      remap(numCapacity ? numCapacity * 2 : 1);
+      data[header->count++] = copy;
+   }
+   else
+      data[header->count++] = t;
+}
+
+/***************************************
+ * MAPPED VECTOR :: RESERVE
+ * Grow the file to hold newCapacity elements
+ *     INPUT  : newCapacity
+ **************************************/
+template <typename T>
+void mapped_vector <T> :: reserve(size_t newCapacity)
+{
+   if (newCapacity > numCapacity)
+      remap(newCapacity);
+}
+
+/***************************************
+ * MAPPED VECTOR :: RESIZE
+ * Change the size; new elements are value-initialized
+ *     INPUT  : newElements
+ **************************************/
+template <typename T>
+void mapped_vector <T> :: resize(size_t newElements)
+{
+   reserve(newElements);
+   for (size_t i = size(); i < newElements; i++)
+      data[i] = T();
+   if (header)
+      header->count = newElements;
+}
+
+/***************************************
+ * MAPPED VECTOR :: FLUSH
+ * Write dirty pages back to the file now rather
+ * than whenever the OS gets around to it
+ **************************************/
+template <typename T>
+void mapped_vector <T> :: flush()
+{
+   if (header == nullptr)
+      return;
+#ifdef _WIN32
+   FlushViewOfFile(header, 0);
+   FlushFileBuffers(file);
+#else
+   msync(header, fileBytes(numCapacity), MS_SYNC);
+#endif
+}
+
+/***************************************
+ * MAPPED VECTOR :: REMAP
+ * Grow the file and map it again.  The header
+ * and elements come along because they are the file.
+ * On failure the old size and mapping are put back;
+ * if even that fails the file is closed and the
+ * vector is left empty
+ *     INPUT  : newCapacity > numCapacity
+ **************************************/
+template <typename T>
+void mapped_vector <T> :: remap(size_t newCapacity)
+{
+   assert(newCapacity > numCapacity);
+   if (header == nullptr)
+      throw std::runtime_error("mapped_vector: no file is open");
+   if (newCapacity > ((size_t)-1 - dataOffset) / sizeof(T))
+      throw std::runtime_error("mapped_vector: too many elements");
+
+   unmapFile();
+   try
+   {
+      resizeFile(fileBytes(newCapacity));
+      mapFile(fileBytes(newCapacity));
+   }
+   catch (...)
+   {
+      try
+      {
+         resizeFile(fileBytes(numCapacity));
+         mapFile(fileBytes(numCapacity));
+      }
+      catch (...)
+      {
+         closeFile();
+         numCapacity = 0;
+      }
+      throw;
+   }
+   numCapacity = newCapacity;
+}
+
+/***************************************
+ * MAPPED VECTOR :: CLOSE
+ * Unmap and trim the file down to the elements
+ * in use so the spare capacity is not kept on disk.
+ * The file is closed even if nothing is mapped
+ **************************************/
+template <typename T>
+void mapped_vector <T> :: close()
+{
+   if (header != nullptr)
+   {
+      size_t used = size();
+      unmapFile();
+      try
+      {
+         resizeFile(fileBytes(used));
+      }
+      catch (...)
+      {
+         // the spare capacity just stays in the file
+      }
+   }
+   closeFile();
+   numCapacity = 0;
+}
+
+#ifdef _WIN32
+
+/***************************************
+ * MAPPED VECTOR :: PLATFORM
+ * Windows: a file mapping object has a fixed size,
+ * so it is rebuilt every time the file changes size
+ **************************************/
+template <typename T>
+size_t mapped_vector <T> :: openFile(const char * path)
+{
+   mapping = nullptr;
+   file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                      OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("mapped_vector: unable to open file");
+
+   LARGE_INTEGER bytes;
+   if (!GetFileSizeEx(file, &bytes))
+   {
+      CloseHandle(file);
+      throw std::runtime_error("mapped_vector: unable to size file");
+   }
+   return (size_t)bytes.QuadPart;
+}
+
+template <typename T>
+void mapped_vector <T> :: resizeFile(size_t bytes)
+{
+   LARGE_INTEGER end;
+   end.QuadPart = (LONGLONG)bytes;
+   if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+      throw std::runtime_error("mapped_vector: unable to resize file");
+}
+
+template <typename T>
+void mapped_vector <T> :: mapFile(size_t bytes)
+{
+   mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+   void * p = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes)
+                      : nullptr;
+   if (p == nullptr)
+   {
+      if (mapping)
+         CloseHandle(mapping);
+      mapping = nullptr;
+      throw std::runtime_error("mapped_vector: unable to map file");
+   }
+   header = static_cast<Header *>(p);
+   data = reinterpret_cast<T *>(static_cast<char *>(p) + dataOffset);
+}
+
+template <typename T>
+void mapped_vector <T> :: unmapFile()
+{
+   UnmapViewOfFile(header);
+   CloseHandle(mapping);
+   mapping = nullptr;
+   header = nullptr;
+   data = nullptr;
+}
+
+template <typename T>
+void mapped_vector <T> :: closeFile()
+{
+   if (file != INVALID_HANDLE_VALUE)
+      CloseHandle(file);
+   file = INVALID_HANDLE_VALUE;
+}
+
+#else // !_WIN32
+
+/***************************************
+ * MAPPED VECTOR :: PLATFORM
+ * POSIX: a shared mapping of the file descriptor,
+ * so stores go straight into the page cache
+ **************************************/
+template <typename T>
+size_t mapped_vector <T> :: openFile(const char * path)
+{
+   fd = ::open(path, O_RDWR | O_CREAT, 0644);
+   if (fd < 0)
+      throw std::runtime_error("mapped_vector: unable to open file");
+
+   struct stat st;
+   if (fstat(fd, &st) != 0)
+   {
+      ::close(fd);
+      throw std::runtime_error("mapped_vector: unable to size file");
+   }
+   return (size_t)st.st_size;
+}
+
+template <typename T>
+void mapped_vector <T> :: resizeFile(size_t bytes)
+{
+   if (ftruncate(fd, (off_t)bytes) != 0)
+      throw std::runtime_error("mapped_vector: unable to resize file");
+}
+
+template <typename T>
+void mapped_vector <T> :: mapFile(size_t bytes)
+{
+   void * p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (p == MAP_FAILED)
+      throw std::runtime_error("mapped_vector: unable to map file");
+   header = static_cast<Header *>(p);
+   data = reinterpret_cast<T *>(static_cast<char *>(p) + dataOffset);
+}
+
+template <typename T>
+void mapped_vector <T> :: unmapFile()
+{
+   munmap(header, fileBytes(numCapacity));
+   header = nullptr;
+   data = nullptr;
+}
+
+template <typename T>
+void mapped_vector <T> :: closeFile()
+{
+   if (fd >= 0)
+      ::close(fd);
+   fd = -1;
+}
+
+#endif // _WIN32
+
+} // namespace custom
@@ -0,0 +1,255 @@
+/***********************************************************************
+ * Header:
+ *    MMAP ALLOCATOR
+ * Summary:
+ *    An allocator for very large vectors.  Each buffer sits at the
+ *    front of a big reservation of address space, so growing the
+ *    buffer never has to move it:
+ *
+ *       custom::vector<Record, custom::mmap_allocator<Record>> v;
+ *
+ *    Pages are only backed by memory when they are first touched,
+ *    and on Linux the reservation is aligned to 2MB and advised for
+ *    transparent huge pages.
+ *
+ *    This will contain the class definition of:
+ *        mmap_allocator         : Reserve big, commit lazily, grow in place
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uintptr_t
+#include <new>      // for std::bad_alloc
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0  // not every POSIX system has it
+#endif
+#endif
+
+class TestMmapAllocator; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * MMAP ALLOCATOR
+ * allocate() reserves max(request, reserveBytes) of
+ * address space but only the request is committed.
+ * expand() lets vector grow into the rest of the
+ * reservation without moving a single element
+ ****************************************/
+template <typename T>
+class mmap_allocator
+{
+   template <typename U> friend class mmap_allocator;
+   friend class ::TestMmapAllocator;
+public:
+   typedef T value_type;
+
+   // one huge page: the unit of reservation
+   static const size_t hugePage = 2 * 1024 * 1024;
+
+   // how much address space each buffer reserves by default
+   static const size_t defaultReserve =
+      sizeof(void *) >= 8 ? (size_t)64 * 1024 * 1024 * 1024  // 64GB
+                          : (size_t)256 * 1024 * 1024;        // 256MB
+
+   //
+   // Construct
+   //
+
+   mmap_allocator(size_t reserveBytes = defaultReserve) :
+      reserveBytes(roundUp(reserveBytes)) { }
+   template <typename U>
+   mmap_allocator(const mmap_allocator<U> & rhs) :
+      reserveBytes(rhs.reserveBytes) { }
+
+   //
+   // Allocate
+   //
+
+   T * allocate(size_t num);
+   void deallocate(T * p, size_t num);
+   bool expand(T * p, size_t num, size_t newNum);
+
+   //
+   // Compare: two allocators can free each other's buffers
+   // only when they size reservations the same way
+   //
+
+   template <typename U>
+   bool operator == (const mmap_allocator<U> & rhs) const
+   {
+      return reserveBytes == rhs.reserveBytes;
+   }
+   template <typename U>
+   bool operator != (const mmap_allocator<U> & rhs) const
+   {
+      return !(*this == rhs);
+   }
+
+private:
+   static size_t roundUp(size_t bytes)
+   {
+      return (bytes + hugePage - 1) / hugePage * hugePage;
+   }
+   size_t reservationFor(size_t num) const
+   {
+      size_t bytes = roundUp(num * sizeof(T));
+      return bytes > reserveBytes ? bytes : reserveBytes;
+   }
+
+   static void * reserve(size_t bytes);
+   static bool commit(void * p, size_t bytes);
+   static void release(void * p, size_t bytes);
+
+   size_t reserveBytes;       // address space set aside for each buffer
+};
+
+/***************************************
+ * MMAP ALLOCATOR :: ALLOCATE
+ * Reserve a region big enough for num elements
+ * plus room to grow, and commit the first num
+ *     INPUT  : num > 0
+ *     OUTPUT : an uninitialized buffer
+ **************************************/
+template <typename T>
+T * mmap_allocator <T> :: allocate(size_t num)
+{
+   assert(num > 0);
+   if (num > ((size_t)-1 - hugePage) / sizeof(T))
+      throw std::bad_alloc();
+
+   size_t bytes = reservationFor(num);
+   void * p = reserve(bytes);
+   if (!commit(p, num * sizeof(T)))
+   {
+      release(p, bytes);
+      throw std::bad_alloc();
+   }
+   return static_cast<T *>(p);
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: DEALLOCATE
+ * Give back the whole reservation
+ *     INPUT  : p and num, as handed out by allocate()
+ *              or grown by expand()
+ **************************************/
+template <typename T>
+void mmap_allocator <T> :: deallocate(T * p, size_t num)
+{
+   if (p)
+      release(p, reservationFor(num));
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: EXPAND
+ * Grow a buffer from num to newNum elements
+ * without moving it.  This only works while the
+ * buffer still fits in its original reservation
+ *     INPUT  : p with num elements, newNum > num
+ *     OUTPUT : true if p now holds newNum elements
+ **************************************/
+template <typename T>
+bool mmap_allocator <T> :: expand(T * p, size_t num, size_t newNum)
+{
+   assert(p != nullptr && newNum > num);
+   if (newNum > (size_t)-1 / sizeof(T) ||
+       newNum * sizeof(T) > reservationFor(num))
+      return false;
+   return commit(p, newNum * sizeof(T));
+}
+
+#ifdef _WIN32
+
+/***************************************
+ * MMAP ALLOCATOR :: RESERVE, COMMIT, RELEASE
+ * Windows: reserve address space, then commit
+ * pages as the buffer grows into them
+ **************************************/
+template <typename T>
+void * mmap_allocator <T> :: reserve(size_t bytes)
+{
+   void * p = VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_READWRITE);
+   if (p == nullptr)
+      throw std::bad_alloc();
+   return p;
+}
+
+template <typename T>
+bool mmap_allocator <T> :: commit(void * p, size_t bytes)
+{
+   return VirtualAlloc(p, bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+template <typename T>
+void mmap_allocator <T> :: release(void * p, size_t /* bytes */)
+{
+   VirtualFree(p, 0, MEM_RELEASE);
+}
+
+#else // !_WIN32
+
+/***************************************
+ * MMAP ALLOCATOR :: RESERVE
+ * POSIX: map an anonymous region without swap
+ * reservation.  The kernel backs each page on
+ * first touch, so untouched pages cost nothing.
+ * Over-map by a huge page so the region can be
+ * trimmed to 2MB alignment for THP
+ *     INPUT  : bytes, a multiple of hugePage
+ **************************************/
+template <typename T>
+void * mmap_allocator <T> :: reserve(size_t bytes)
+{
+   size_t mapped = bytes + hugePage;
+   void * p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   if (p == MAP_FAILED)
+      throw std::bad_alloc();
+
+   // trim the unaligned head and the leftover tail
+   uintptr_t start = reinterpret_cast<uintptr_t>(p);
+   uintptr_t aligned = (start + hugePage - 1) / hugePage * hugePage;
+   if (aligned > start)
+      munmap(p, aligned - start);
+   if (aligned + bytes < start + mapped)
+      munmap(reinterpret_cast<void *>(aligned + bytes),
+             start + mapped - (aligned + bytes));
+
+#ifdef MADV_HUGEPAGE
+   madvise(reinterpret_cast<void *>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+   return reinterpret_cast<void *>(aligned);
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: COMMIT
+ * POSIX: nothing to do, pages fault in on demand
+ **************************************/
+template <typename T>
+bool mmap_allocator <T> :: commit(void * /* p */, size_t /* bytes */)
+{
+   return true;
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: RELEASE
+ * POSIX: unmap the whole reservation
+ **************************************/
+template <typename T>
+void mmap_allocator <T> :: release(void * p, size_t bytes)
+{
+   munmap(p, bytes);
+}
+
+#endif // _WIN32
+
+} // namespace custom
@@ -0,0 +1,419 @@
+/***********************************************************************
+ * Header:
+ *    PACKED VECTOR
+ * Summary:
+ *    A read-optimized, compressed vector of 64-bit integers.  Values
+ *    are kept in blocks of 128, and each block is bit-packed at the
+ *    smallest width that holds it, so IDs that fit in 20-30 bits take
+ *    20-30 bits, not 64:
+ *
+ *       custom::packed_vector ids(begin, end, custom::packed_vector::delta);
+ *       uint64_t id = ids[i];                  // random access
+ *       for (uint64_t id : ids) ...            // decodes a block at a time
+ *
+ *    There are two encodings:
+ *       frame : each value is stored as its distance from the smallest
+ *               value in its block.  Any values; random access is O(1)
+ *       delta : each value is stored as its distance from the one
+ *               before it.  Values must never decrease, but a sorted
+ *               list with small gaps packs into a few bits a value.
+ *               Random access decodes from the start of the block
+ *
+ *    The block table (the base value, width and position of every
+ *    block) is the skip table: finding value i is one lookup.  The
+ *    last, partly full block is kept unpacked until it fills.
+ *
+ *    This will contain the class definition of:
+ *        packed_vector                  : A bit-packed vector of uint64_t
+ *        packed_vector::const_iterator  : Decodes a block at a time
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>   // because I am paranoid
+#include <cstdint>   // for uint64_t
+#include <cstddef>   // for size_t
+#include <cstring>   // for std::memcpy
+#include <iterator>  // for std::forward_iterator_tag
+#include <stdexcept> // for std::invalid_argument
+#include <initializer_list>
+#include "vector.h"
+
+class TestPackedVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * PACKED VECTOR
+ * Blocks [0, numPacked / blockSize) are packed into
+ * words; the last numTail values wait in tail until
+ * there are a block's worth.  A block of width w
+ * takes exactly 2w words (128 * w bits), so every
+ * block starts on a word boundary
+ ****************************************/
+class packed_vector
+{
+   friend class ::TestPackedVector; // give unit tests access to the privates
+public:
+   typedef uint64_t value_type;
+
+   enum encoding { frame, delta };
+   static const size_t blockSize = 128;
+
+   //
+   // Construct
+   //
+
+   packed_vector(encoding how = frame) :
+      how(how), numPacked(0), numTail(0), previous(0) { }
+   packed_vector(const std::initializer_list<uint64_t> & l, encoding how = frame) :
+      how(how), numPacked(0), numTail(0), previous(0)
+   {
+      for (uint64_t value : l)
+         push_back(value);
+   }
+   template <class Iterator>
+   packed_vector(Iterator first, Iterator last, encoding how = frame) :
+      how(how), numPacked(0), numTail(0), previous(0)
+   {
+      for (; first != last; ++first)
+         push_back(*first);
+   }
+
+   //
+   // Iterator
+   //
+
+   class const_iterator;
+   typedef const_iterator iterator;
+   const_iterator begin() const;
+   const_iterator end()   const;
+
+   //
+   // Access
+   //
+
+   uint64_t operator [] (size_t index) const;
+   uint64_t front() const { return (*this)[0]; }
+   uint64_t back()  const { return (*this)[size() - 1]; }
+   void decode(size_t first, size_t num, uint64_t * out) const;
+
+   //
+   // Insert
+   //
+
+   void push_back(uint64_t value);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      words.clear();
+      blocks.clear();
+      numPacked = numTail = 0;
+      previous = 0;
+   }
+
+   //
+   // Status
+   //
+
+   size_t   size()         const { return numPacked + numTail; }
+   bool     empty()        const { return size() == 0; }
+   encoding get_encoding() const { return how; }
+   size_t   memory_usage() const;
+
+private:
+   // one entry of the skip table
+   struct block
+   {
+      uint64_t base;            // frame: the smallest value; delta: the first
+      uint64_t firstWord : 56;  // where the block starts in words
+      uint64_t width     : 8;   // bits per value, 0 to 64
+   };
+
+   static unsigned widthOf(uint64_t maxValue);
+   uint64_t extract(const block & b, size_t j) const;
+   void unpack(size_t k, uint64_t * out) const;
+   void pack();
+
+   encoding how;                 // frame or delta
+   vector <uint64_t> words;      // every packed block, back to back
+   vector <block> blocks;        // the skip table: one per packed block
+   size_t numPacked;             // values in packed blocks
+   uint64_t tail[blockSize];     // the last, unpacked values
+   size_t numTail;               // how many of them there are
+   uint64_t previous;            // the last value pushed
+};
+
+/**************************************************
+ * PACKED VECTOR ITERATOR
+ * A forward iterator that unpacks one whole block
+ * into its own buffer when it steps into it, so a
+ * scan costs one unpack per 128 values.  That makes
+ * it a kilobyte: walk with it, do not hoard copies
+ *************************************************/
+class packed_vector :: const_iterator
+{
+public:
+   typedef std::forward_iterator_tag iterator_category;
+   typedef uint64_t                  value_type;
+   typedef std::ptrdiff_t            difference_type;
+   typedef const uint64_t *          pointer;
+   typedef uint64_t                  reference;
+
+   const_iterator() : pv(nullptr), index(0) { }
+   const_iterator(const packed_vector * pv, size_t index) : pv(pv), index(index)
+   {
+      if (index < pv->numPacked)
+         pv->unpack(index / blockSize, buffer);
+   }
+
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+
+   uint64_t operator * () const
+   {
+      if (index < pv->numPacked)
+         return buffer[index % blockSize];
+      return pv->tail[index - pv->numPacked];
+   }
+
+   const_iterator & operator ++ ()
+   {
+      ++index;
+      if (index % blockSize == 0 && index < pv->numPacked)
+         pv->unpack(index / blockSize, buffer);
+      return *this;
+   }
+   const_iterator operator ++ (int)
+   {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+   }
+
+private:
+   const packed_vector * pv;       // the vector we walk
+   size_t index;                   // which value we are on
+   uint64_t buffer[blockSize];     // the block holding index, unpacked
+};
+
+inline packed_vector::const_iterator packed_vector :: begin() const { return const_iterator(this, 0); }
+inline packed_vector::const_iterator packed_vector :: end()   const { return const_iterator(this, size()); }
+
+/***************************************
+ * PACKED VECTOR :: SUBSCRIPT
+ * One skip table lookup finds the block.  Frame is
+ * then one extract; delta adds up the deltas from
+ * the start of the block
+ *     INPUT  : index < size()
+ *     OUTPUT : the value
+ **************************************/
+inline uint64_t packed_vector :: operator [] (size_t index) const
+{
+   assert(index < size());
+   if (index >= numPacked)
+      return tail[index - numPacked];
+
+   const block & b = blocks[index / blockSize];
+   size_t j = index % blockSize;
+   if (how == frame)
+      return b.base + extract(b, j);
+
+   uint64_t value = b.base;
+   for (size_t i = 1; i <= j; i++)
+      value += extract(b, i);
+   return value;
+}
+
+/***************************************
+ * PACKED VECTOR :: DECODE
+ * Copy values [first, first + num) out, a whole
+ * block at a time where possible.  This is the fast
+ * way to scan
+ *     INPUT  : first, num within size()
+ *     OUTPUT : out[0, num) holds the values
+ **************************************/
+inline void packed_vector :: decode(size_t first, size_t num, uint64_t * out) const
+{
+   assert(first + num <= size());
+   uint64_t buffer[blockSize];
+   while (num > 0 && first < numPacked)
+   {
+      size_t j = first % blockSize;
+      size_t take = blockSize - j;
+      if (take > num)
+         take = num;
+      if (take == blockSize)
+         unpack(first / blockSize, out);
+      else
+      {
+         unpack(first / blockSize, buffer);
+         std::memcpy(out, buffer + j, take * sizeof(uint64_t));
+      }
+      first += take;
+      out += take;
+      num -= take;
+   }
+   if (num > 0)
+      std::memcpy(out, tail + (first - numPacked), num * sizeof(uint64_t));
+}
+
+/***************************************
+ * PACKED VECTOR :: PUSH BACK
+ * Add to the unpacked tail, packing it into a new
+ * block once it is full
+ *     INPUT  : value; with delta encoding, no less
+ *              than the value before it
+ **************************************/
+inline void packed_vector :: push_back(uint64_t value)
+{
+   if (how == delta && !empty() && value < previous)
+      throw std::invalid_argument("packed_vector: delta encoding needs non-decreasing values");
+
+   tail[numTail++] = value;
+   previous = value;
+   if (numTail == blockSize)
+      pack();
+}
+
+/***************************************
+ * PACKED VECTOR :: MEMORY USAGE
+ *     OUTPUT : bytes held, object and heap together
+ **************************************/
+inline size_t packed_vector :: memory_usage() const
+{
+   return sizeof(*this) +
+          words.capacity()  * sizeof(uint64_t) +
+          blocks.capacity() * sizeof(block);
+}
+
+/***************************************
+ * PACKED VECTOR :: WIDTH OF
+ *     OUTPUT : the bits needed to hold maxValue
+ **************************************/
+inline unsigned packed_vector :: widthOf(uint64_t maxValue)
+{
+   if (maxValue == 0)
+      return 0;
+#if defined(__GNUC__)
+   return 64 - (unsigned)__builtin_clzll(maxValue);
+#else
+   unsigned width = 0;
+   while (maxValue)
+   {
+      maxValue >>= 1;
+      width++;
+   }
+   return width;
+#endif
+}
+
+/***************************************
+ * PACKED VECTOR :: EXTRACT
+ * The j-th packed field of block b.  A field may
+ * straddle two words
+ *     OUTPUT : the raw field, not yet added to base
+ **************************************/
+inline uint64_t packed_vector :: extract(const block & b, size_t j) const
+{
+   unsigned width = (unsigned)b.width;
+   if (width == 0)
+      return 0;
+
+   size_t bit = j * width;
+   size_t w = (size_t)b.firstWord + bit / 64;
+   unsigned shift = bit % 64;
+   uint64_t field = words[w] >> shift;
+   if (shift + width > 64)
+      field |= words[w + 1] << (64 - shift);
+   return width == 64 ? field : field & ((uint64_t(1) << width) - 1);
+}
+
+/***************************************
+ * PACKED VECTOR :: UNPACK
+ * Decode all 128 values of block k
+ *     INPUT  : k a packed block
+ *     OUTPUT : out[0, blockSize) holds its values
+ **************************************/
+inline void packed_vector :: unpack(size_t k, uint64_t * out) const
+{
+   const block & b = blocks[k];
+   for (size_t j = 0; j < blockSize; j++)
+      out[j] = extract(b, j);
+
+   if (how == frame)
+      for (size_t j = 0; j < blockSize; j++)
+         out[j] += b.base;
+   else
+   {
+      uint64_t value = b.base;
+      for (size_t j = 0; j < blockSize; j++)
+         out[j] = value += out[j];
+   }
+}
+
+/***************************************
+ * PACKED VECTOR :: PACK
+ * Turn the full tail into a block: work out the
+ * fields (offsets from the minimum, or deltas), find
+ * the widest, and lay them out that many bits apart
+ **************************************/
+inline void packed_vector :: pack()
+{
+   assert(numTail == blockSize);
+   uint64_t fields[blockSize];
+   block b;
+
+   if (how == frame)
+   {
+      b.base = tail[0];
+      for (size_t j = 1; j < blockSize; j++)
+         if (tail[j] < b.base)
+            b.base = tail[j];
+      for (size_t j = 0; j < blockSize; j++)
+         fields[j] = tail[j] - b.base;
+   }
+   else
+   {
+      b.base = tail[0];
+      fields[0] = 0;
+      for (size_t j = 1; j < blockSize; j++)
+         fields[j] = tail[j] - tail[j - 1];
+   }
+
+   uint64_t widest = 0;
+   for (size_t j = 0; j < blockSize; j++)
+      widest |= fields[j];
+   unsigned width = widthOf(widest);
+   b.width = width;
+   b.firstWord = words.size();
+
+   if (width > 0)
+   {
+      uint64_t word = 0;
+      unsigned used = 0;
+      for (size_t j = 0; j < blockSize; j++)
+      {
+         word |= fields[j] << used;
+         used += width;
+         if (used >= 64)
+         {
+            words.push_back(word);
+            used -= 64;
+            word = used ? fields[j] >> (width - used) : 0;
+         }
+      }
+      assert(used == 0);
+   }
+
+   blocks.push_back(b);
+   numPacked += blockSize;
+   numTail = 0;
+}
+
+} // namespace custom
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <cassert>
+#include <iterator>  // for std::distance, std::iterator_traits
 #include "vector.h"
 
 class TestPQueue;    // forward declaration for unit test class
@@ -28,16 +29,20 @@ namespace custom
 
 /*************************************************
  * P QUEUE
- * Create a priority queue.
+ * Create a priority queue.  The heap lives in
+ * Container, which also supplies the allocator
  *************************************************/
-template<class T>
+template<class T, class Container = custom::vector<T>>
 class priority_queue
 {
    friend class ::TestPQueue; // give the unit test class access to the privates
-   template <class TT>
-   friend void swap(priority_queue<TT>& lhs, priority_queue<TT>& rhs);
+   template <class TT, class CC>
+   friend void swap(priority_queue<TT, CC>& lhs, priority_queue<TT, CC>& rhs);
 public:
 
+   typedef Container container_type;
+   typedef typename Container::allocator_type allocator_type;
+
    //
    // construct
    //
@@ -45,26 +50,33 @@ public:
     {
     }
     
+    explicit priority_queue(const allocator_type& a) : container(a) {}
+    
     priority_queue(const priority_queue& rhs) : container(rhs.container) {}
     
     priority_queue(priority_queue&& rhs) noexcept : container(std::move(rhs.container)) {}
     
     template <class Iterator>
     
-    priority_queue(Iterator first, Iterator last) 
+    priority_queue(Iterator first, Iterator last, const allocator_type& a = allocator_type())
+       : container(a)
     {
-        container.resize(0);
+        reserveFor(first, last,
+                   typename std::iterator_traits<Iterator>::iterator_category());
         while (first != last) {
-            push(*first);
+            container.push_back(*first);
             ++first;
         }
+        heapify();
+    }
+    explicit priority_queue(Container&& rhs) : container(std::move(rhs))
+    {
+        heapify();
     }
-    explicit priority_queue(custom::vector<T>&& rhs) : container(std::move(rhs)) {}
     
-    explicit priority_queue(custom::vector<T>& rhs) {
-        for (const auto& element : rhs) {
-            push(element);
-        }
+    explicit priority_queue(const Container& rhs) : container(rhs)
+    {
+        heapify();
     }
     
     ~priority_queue() {}
@@ -80,6 +92,8 @@ public:
    //
    void  push(const T& t);
    void  push(T&& t);
+   template <class ... Args>
+   void  emplace(Args&& ... args);
 
    //
    // Remove
@@ -102,8 +116,16 @@ public:
 private:
 
    bool percolateDown(size_t indexHeap);      // fix heap from index down. This is a heap index!
+   void heapify();                            // put the whole container in heap order
+   template <class InputIt>
+   void reserveFor(InputIt, InputIt, std::input_iterator_tag) {}
+   template <class ForwardIt>
+   void reserveFor(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+   {
+      container.reserve(std::distance(first, last));
+   }
 
-   custom::vector<T> container;
+   Container container;
 
 };
 
@@ -111,8 +133,8 @@ private:
  * P QUEUE :: TOP
  * Get the maximum item from the heap: the top item.
  ***********************************************/
-template <class T>
-const T & priority_queue <T> :: top() const
+template <class T, class Container>
+const T & priority_queue <T, Container> :: top() const
 {
     if (!container.empty())
         {
@@ -127,14 +149,14 @@ const T & priority_queue <T> :: top() const
  * P QUEUE :: POP
  * Delete the top item from the heap.
  **********************************************/
-template <class T>
-void priority_queue <T> :: pop()
+template <class T, class Container>
+void priority_queue <T, Container> :: pop()
 {
     if (!container.empty())
         {
             std::swap(container[0], container.back());
             container.pop_back();
-            percolateDown(0);
+            percolateDown(1);
         }
 }
 
@@ -142,43 +164,32 @@ void priority_queue <T> :: pop()
  * P QUEUE :: PUSH
  * Add a new element to the heap, reallocating as necessary
  ****************************************/
-template <class T>
-void priority_queue<T>::push(const T& t)
+template <class T, class Container>
+void priority_queue <T, Container> ::push(const T& t)
 {
-    container.push_back(t);
-    size_t currentIndex;
-    if (container.size() >= 3) {
-        
-        currentIndex = container.size() / 2 + 1;
-        
-    } else {
-        currentIndex = 1;
-        
-        
-    }
-    while (currentIndex and percolateDown(currentIndex)){
-        currentIndex = currentIndex / 2;
-    }
-    container.shrink_to_fit();
+    emplace(t);
 }
 
-template <class T>
-void priority_queue<T>::push(T&& t)
+template <class T, class Container>
+void priority_queue <T, Container> ::push(T&& t)
 {
-    container.push_back(std::move(t));
-    size_t currentIndex;
-    if (container.size() >= 3) {
-        
-        currentIndex = container.size() / 2 + 1;
-        
-    } else {
-        currentIndex = 1;
-        percolateDown(currentIndex);
-    }
-    while (currentIndex and percolateDown(currentIndex)){
-        currentIndex = currentIndex / 2 ;
+    emplace(std::move(t));
+}
+
+/*****************************************
+ * P QUEUE :: EMPLACE
+ * Build a new element at the end of the heap from
+ * args, then walk up the parents until it is in order
+ ****************************************/
+template <class T, class Container>
+template <class ... Args>
+void priority_queue <T, Container> ::emplace(Args&& ... args)
+{
+    container.emplace_back(std::forward<Args>(args)...);
+    size_t indexHeap = container.size() / 2;
+    while (indexHeap && percolateDown(indexHeap)) {
+        indexHeap /= 2;
     }
-    container.shrink_to_fit();
 }
 
 
@@ -188,61 +199,51 @@ void priority_queue<T>::push(T&& t)
  * order. Take care of that little detail!
  * Return TRUE if anything changed.
  ************************************************/
-template <class T>
-bool priority_queue<T>::percolateDown(size_t indexHeap)
+template <class T, class Container>
+bool priority_queue <T, Container> ::percolateDown(size_t indexHeap)
 {
-    std::cout << "Percolating\n";
+    size_t indexLeft = indexHeap * 2;
+    size_t indexRight = indexLeft + 1;
+    size_t indexBigger;
     
-    //{9}
-
+    if (indexRight <= container.size() &&
+        container[indexLeft - 1] < container[indexRight - 1]) {
+        indexBigger = indexRight;
+    }
+    else {
+        indexBigger = indexLeft;
+    }
     
-//    size_t indexLeft;
-//    size_t indexRight;
-//
-//    if (indexHeap == 0) {
-//        indexLeft = 1;
-//        indexRight = 2;
-//    }
-//
-//    else {
+    if (indexBigger <= container.size() &&
+        container[indexHeap - 1] < container[indexBigger - 1]) {
+        std::swap(container[indexHeap - 1], container[indexBigger - 1]);
+        percolateDown(indexBigger);
+        return true;
+    }
     
-    if (container.size() < 3) {
-        if (container[0] < container[1]) {
-            std::swap(container[0],container[1]);
-            return true;
-        }
-        return false;
-    } else {
-        
-        size_t indexLeft = indexHeap * 2 + 1;
-        size_t indexRight = indexLeft + 1;
-        size_t indexBigger;
-        
-        
-        if (container[indexRight-1] <= container[indexHeap-1] && container[indexLeft-1] < container[indexRight-1]) {
-            indexBigger = indexRight;
-        }
-        else {
-            indexBigger = indexLeft;
-        }
-        
-        if (container[indexHeap-1] < container[indexBigger-1]) {
-            std::swap(container[indexHeap-1],container[indexBigger-1]);
-            return percolateDown(indexBigger);
-        }
-        
-        return false;
+    return false;
+}
+
+/************************************************
+ * P QUEUE :: HEAPIFY
+ * Turn an unordered container into a heap by
+ * percolating every parent down, last one first
+ ************************************************/
+template <class T, class Container>
+void priority_queue <T, Container> ::heapify()
+{
+    for (size_t indexHeap = container.size() / 2; indexHeap >= 1; --indexHeap) {
+        percolateDown(indexHeap);
     }
 }
-//        k
 
 /************************************************
  * SWAP
  * Swap the contents of two priority queues
  ************************************************/
-template <class T>
-inline void swap(custom::priority_queue <T>& lhs,
-                 custom::priority_queue <T>& rhs)
+template <class T, class Container>
+inline void swap(custom::priority_queue <T, Container>& lhs,
+                 custom::priority_queue <T, Container>& rhs)
 {
     
     std::swap(lhs.container, rhs.container);
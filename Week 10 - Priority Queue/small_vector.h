@@ -0,0 +1,494 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first N elements inside the object
+ *    itself and only goes to the heap when it outgrows them
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A vector with N elements of inline storage
+ *        small_vector::iterator : The same iterator as vector::iterator
+ *        small_vector::const_iterator : The same as vector::const_iterator
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <memory>   // for std::allocator
+#include <utility>  // for std::move_if_noexcept
+#include <type_traits> // for std::is_nothrow_move_constructible
+#include "vector.h" // for vector::iterator
+
+class TestSmallVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SMALL VECTOR
+ * Just like custom::vector, except the first N
+ * elements live in the object: no allocation at all
+ * until the N+1st push
+ ****************************************/
+template <typename T, size_t N>
+class small_vector
+{
+   static_assert(N > 0, "small_vector needs at least one inline slot");
+   friend class ::TestSmallVector; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+
+   small_vector();
+   small_vector(size_t numElements                );
+   small_vector(size_t numElements, const T & t   );
+   small_vector(const std::initializer_list<T>& l );
+   small_vector(const small_vector &  rhs);
+   small_vector(      small_vector && rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+   ~small_vector();
+
+   //
+   // Assign
+   //
+
+   void swap(small_vector& rhs);
+   small_vector & operator = (const small_vector & rhs);
+   small_vector & operator = (small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+   //
+   // Iterator
+   //
+
+   typedef typename vector <T> :: iterator               iterator;
+   typedef typename vector <T> :: const_iterator         const_iterator;
+   typedef typename vector <T> :: reverse_iterator       reverse_iterator;
+   typedef typename vector <T> :: const_reverse_iterator const_reverse_iterator;
+   iterator       begin() { return iterator(data); }
+   iterator        end() { return iterator(data + numElements); }
+   const_iterator begin()  const { return const_iterator(data); }
+   const_iterator end()    const { return const_iterator(data + numElements); }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end(); }
+   reverse_iterator       rbegin()        { return reverse_iterator(end()); }
+   reverse_iterator       rend()          { return reverse_iterator(begin()); }
+   const_reverse_iterator rbegin()  const { return const_reverse_iterator(end()); }
+   const_reverse_iterator rend()    const { return const_reverse_iterator(begin()); }
+   const_reverse_iterator crbegin() const { return rbegin(); }
+   const_reverse_iterator crend()   const { return rend(); }
+
+   //
+   // Access
+   //
+
+         T& operator [] (size_t index)       { return data[index]; }
+   const T& operator [] (size_t index) const { return data[index]; }
+         T& front()                          { return data[0]; }
+   const T& front()                    const { return data[0]; }
+         T& back()                           { return data[numElements - 1]; }
+   const T& back()                     const { return data[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T& t) { emplace_back(t);            }
+   void push_back(T&& t)      { emplace_back(std::move(t)); }
+   template <class ... Args>
+   T& emplace_back(Args&& ... args);
+   template <class ... Args>
+   iterator emplace(iterator pos, Args&& ... args);
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements);
+   void resize(size_t newElements, const T& t);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+       destroy(0, numElements);
+       numElements = 0;
+   }
+   void pop_back()
+   {
+       if (numElements > 0) {
+           --numElements;
+           destroy(numElements, numElements + 1);
+       }
+   }
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+
+    size_t  size()          const { return numElements;}
+    size_t  capacity()      const { return numCapacity;}
+    bool empty()            const { return numElements == 0;}
+    bool isInline()         const { return data == inlineData();}
+
+private:
+
+   typedef std::allocator_traits<std::allocator<T>> traits;
+
+   T       * inlineData()       { return reinterpret_cast<T *>(buffer);       }
+   const T * inlineData() const { return reinterpret_cast<const T *>(buffer); }
+   void destroy(size_t begin, size_t end);
+   void release();
+   void reallocate(size_t newCapacity);
+   void moveFrom(small_vector & rhs);
+
+   std::allocator<T> alloc;   // hands out the heap buffer once we outgrow N
+   alignas(T) unsigned char buffer[N * sizeof(T)]; // the inline slots
+   T *  data;                 // either the inline slots or a heap buffer
+   size_t  numCapacity;       // N while inline, else the heap capacity
+   size_t  numElements;       // the number of items currently used
+};
+
+/*****************************************
+ * SMALL VECTOR :: DEFAULT constructor
+ * Start out in the inline slots: no allocation
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector()
+{
+    data = inlineData();
+    numCapacity = N;
+    numElements = 0;
+}
+
+/*****************************************
+ * SMALL VECTOR :: NON-DEFAULT constructors
+ * Build num elements, inline when they fit
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(size_t num) : small_vector()
+{
+    resize(num);
+}
+
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(size_t num, const T & t) : small_vector()
+{
+    resize(num, t);
+}
+
+/*****************************************
+ * SMALL VECTOR :: INITIALIZATION LIST constructor
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(const std::initializer_list<T> & l) : small_vector()
+{
+    reserve(l.size());
+    for (const T & element : l) {
+        emplace_back(element);
+    }
+}
+
+/*****************************************
+ * SMALL VECTOR :: COPY CONSTRUCTOR
+ * Copy the elements, inline when they fit.  If a
+ * copy throws, uninitialized_copy has destroyed the
+ * ones before it; we still own the heap buffer
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(const small_vector & rhs) : small_vector()
+{
+    reserve(rhs.numElements);
+    try {
+        std::uninitialized_copy(rhs.data, rhs.data + rhs.numElements, data);
+    } catch (...) {
+        release();
+        data = inlineData();
+        numCapacity = N;
+        throw;
+    }
+    numElements = rhs.numElements;
+}
+
+/*****************************************
+ * SMALL VECTOR :: MOVE CONSTRUCTOR
+ * A heap buffer is stolen; inline elements have
+ * to be moved one at a time
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: small_vector(small_vector && rhs)
+   noexcept(std::is_nothrow_move_constructible<T>::value) : small_vector()
+{
+    moveFrom(rhs);
+}
+
+/*****************************************
+ * SMALL VECTOR :: DESTRUCTOR
+ ****************************************/
+template <typename T, size_t N>
+small_vector <T, N> :: ~small_vector()
+{
+    release();
+}
+
+/***************************************
+ * SMALL VECTOR :: ASSIGNMENT
+ * Copy the elements of rhs, reusing our own
+ * storage when it is big enough
+ **************************************/
+template <typename T, size_t N>
+small_vector <T, N> & small_vector <T, N> :: operator = (const small_vector & rhs)
+{
+    if (this != &rhs) {
+        clear();
+        reserve(rhs.numElements);
+        std::uninitialized_copy(rhs.data, rhs.data + rhs.numElements, data);
+        numElements = rhs.numElements;
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+small_vector <T, N> & small_vector <T, N> :: operator = (small_vector && rhs)
+   noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+    if (this != &rhs) {
+        release();
+        data = inlineData();
+        numCapacity = N;
+        moveFrom(rhs);
+    }
+    return *this;
+}
+
+/***************************************
+ * SMALL VECTOR :: SWAP
+ * Two heap buffers just trade pointers.  If either
+ * side is inline the elements themselves must move
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: swap(small_vector & rhs)
+{
+    if (!isInline() && !rhs.isInline()) {
+        std::swap(data, rhs.data);
+        std::swap(numCapacity, rhs.numCapacity);
+        std::swap(numElements, rhs.numElements);
+    } else {
+        small_vector tmp(std::move(rhs));
+        rhs = std::move(*this);
+        *this = std::move(tmp);
+    }
+}
+
+/***************************************
+ * SMALL VECTOR :: EMPLACE BACK
+ * Build a new element at the end from args,
+ * spilling to the heap when the slots run out
+ **************************************/
+template <typename T, size_t N>
+template <class ... Args>
+T & small_vector <T, N> :: emplace_back(Args && ... args)
+{
+    if (numElements == numCapacity) {
+        // args may refer into our own buffer: build first, then grow
+        T t(std::forward<Args>(args)...);
+        reallocate(numCapacity * 2);
+        traits::construct(alloc, data + numElements, std::move(t));
+    } else {
+        traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+    }
+    ++numElements;
+    return data[numElements - 1];
+}
+
+/***************************************
+ * SMALL VECTOR :: EMPLACE
+ * Build a new element in front of pos, shifting
+ * the tail up one slot
+ **************************************/
+template <typename T, size_t N>
+template <class ... Args>
+typename small_vector <T, N> :: iterator small_vector <T, N> :: emplace(iterator pos, Args && ... args)
+{
+    size_t index = pos.p - data;
+    assert(index <= numElements);
+
+    if (index == numElements) {
+        emplace_back(std::forward<Args>(args)...);
+        return iterator(data + index);
+    }
+
+    T t(std::forward<Args>(args)...);
+    if (numElements == numCapacity) {
+        reallocate(numCapacity * 2);
+    }
+
+    traits::construct(alloc, data + numElements, std::move(data[numElements - 1]));
+    ++numElements;
+    for (size_t i = numElements - 2; i > index; --i) {
+        data[i] = std::move(data[i - 1]);
+    }
+    data[index] = std::move(t);
+    return iterator(data + index);
+}
+
+/***************************************
+ * SMALL VECTOR :: RESERVE
+ * Only ever grows; anything up to N is already
+ * there inline
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: reserve(size_t newCapacity)
+{
+    if (newCapacity > numCapacity) {
+        reallocate(newCapacity);
+    }
+}
+
+/***************************************
+ * SMALL VECTOR :: RESIZE
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: resize(size_t newElements)
+{
+    if (newElements < numElements) {
+        destroy(newElements, numElements);
+        numElements = newElements;
+        return;
+    }
+
+    reserve(newElements);
+    for (; numElements < newElements; ++numElements) {
+        traits::construct(alloc, data + numElements);
+    }
+}
+
+template <typename T, size_t N>
+void small_vector <T, N> :: resize(size_t newElements, const T & t)
+{
+    if (newElements < numElements) {
+        destroy(newElements, numElements);
+        numElements = newElements;
+        return;
+    }
+
+    reserve(newElements);
+    for (; numElements < newElements; ++numElements) {
+        traits::construct(alloc, data + numElements, t);
+    }
+}
+
+/***************************************
+ * SMALL VECTOR :: SHRINK TO FIT
+ * Come back inline when the elements fit again,
+ * otherwise trim the heap buffer to size
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: shrink_to_fit()
+{
+    if (!isInline() && numElements < numCapacity) {
+        reallocate(numElements);
+    }
+}
+
+/***************************************
+ * SMALL VECTOR :: DESTROY
+ * Run the destructor on data[begin..end)
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: destroy(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        traits::destroy(alloc, data + i);
+    }
+}
+
+/***************************************
+ * SMALL VECTOR :: RELEASE
+ * Destroy every element and give back the heap
+ * buffer, if there is one
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: release()
+{
+    destroy(0, numElements);
+    numElements = 0;
+    if (!isInline()) {
+        traits::deallocate(alloc, data, numCapacity);
+    }
+}
+
+/***************************************
+ * SMALL VECTOR :: REALLOCATE
+ * Move the elements into storage for newCapacity.
+ * Anything that fits in N goes back to the inline
+ * slots; bigger requests get a heap buffer
+ *     INPUT  : newCapacity >= numElements
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: reallocate(size_t newCapacity)
+{
+    assert(newCapacity >= numElements);
+    bool toInline = newCapacity <= N;
+    if (toInline && isInline()) {
+        return;
+    }
+
+    T * newData = toInline ? inlineData() : traits::allocate(alloc, newCapacity);
+    size_t i = 0;
+    try {
+        for (; i < numElements; ++i) {
+            traits::construct(alloc, newData + i, std::move_if_noexcept(data[i]));
+        }
+    } catch (...) {
+        for (size_t j = 0; j < i; ++j) {
+            traits::destroy(alloc, newData + j);
+        }
+        if (!toInline) {
+            traits::deallocate(alloc, newData, newCapacity);
+        }
+        throw;
+    }
+
+    destroy(0, numElements);
+    if (!isInline()) {
+        traits::deallocate(alloc, data, numCapacity);
+    }
+    data = newData;
+    numCapacity = toInline ? N : newCapacity;
+}
+
+/***************************************
+ * SMALL VECTOR :: MOVE FROM
+ * Take the contents of rhs, which is left empty
+ * and inline.  *this must be empty and inline
+ **************************************/
+template <typename T, size_t N>
+void small_vector <T, N> :: moveFrom(small_vector & rhs)
+{
+    assert(isInline() && numElements == 0);
+    if (rhs.isInline()) {
+        for (; numElements < rhs.numElements; ++numElements) {
+            traits::construct(alloc, data + numElements, std::move(rhs.data[numElements]));
+        }
+        rhs.clear();
+    } else {
+        data = rhs.data;
+        numCapacity = rhs.numCapacity;
+        numElements = rhs.numElements;
+        rhs.data = rhs.inlineData();
+        rhs.numCapacity = N;
+        rhs.numElements = 0;
+    }
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two small vectors
+ ************************************************/
+template <typename T, size_t N>
+inline void swap(small_vector <T, N> & lhs, small_vector <T, N> & rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace custom
@@ -0,0 +1,303 @@
+/***********************************************************************
+ * Header:
+ *    SOA VECTOR
+ * Summary:
+ *    A table of records stored column by column ("structure of
+ *    arrays") rather than record by record:
+ *
+ *       custom::soa_vector<int, double, char> table;
+ *       table.push_back(std::make_tuple(26, 2.6, 'a'));
+ *       custom::span<double> prices = table.column<1>();
+ *
+ *    A query that reads only one field walks one tightly packed
+ *    array instead of dragging every other field through the cache,
+ *    and each column is a plain array the compiler can vectorize.
+ *
+ *    This will contain the class definition of:
+ *        span                   : A pointer and a length, one column
+ *        soa_vector             : One custom::vector per field
+ *        soa_vector::iterator   : Walks the rows, giving tuples of references
+ *        soa_vector::const_iterator : The read-only version of soa_vector::iterator
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <cstddef>  // for size_t and std::ptrdiff_t
+#include <iterator> // for std::random_access_iterator_tag
+#include <tuple>    // for std::tuple
+#include <type_traits> // for std::conditional and std::is_const
+#include <utility>  // for std::index_sequence
+#include "vector.h"
+
+class TestSoaVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SPAN
+ * A view of num contiguous T's.  It does not own
+ * them, so it is only good until the container grows
+ ****************************************/
+template <typename T>
+class span
+{
+public:
+   typedef T value_type;
+   typedef T * iterator;
+
+   span() : p(nullptr), num(0) { }
+   span(T * p, size_t num) : p(p), num(num) { }
+
+   T * data()  const { return p; }
+   size_t size() const { return num; }
+   bool empty()  const { return num == 0; }
+   T * begin() const { return p; }
+   T * end()   const { return p + num; }
+   T & operator [] (size_t index) const { return p[index]; }
+
+private:
+   T * p;
+   size_t num;
+};
+
+/*****************************************
+ * SOA VECTOR
+ * Column I is a custom::vector of the I'th type.
+ * Every column always has the same size: the
+ * row operations touch all of them or none
+ ****************************************/
+template <typename ... Ts>
+class soa_vector
+{
+   friend class ::TestSoaVector; // give unit tests access to the privates
+   static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+public:
+   typedef std::tuple<Ts...>         value_type;
+   typedef std::tuple<Ts &...>       reference;
+   typedef std::tuple<const Ts &...> const_reference;
+
+   template <size_t I>
+   using column_type = typename std::tuple_element<I, value_type>::type;
+
+   //
+   // Construct
+   //
+
+   soa_vector() { }
+
+   //
+   // Iterator
+   //
+
+   template <typename V>
+   class basic_iterator;
+   typedef basic_iterator <soa_vector>       iterator;
+   typedef basic_iterator <const soa_vector> const_iterator;
+   iterator       begin()        { return iterator(this, 0);            }
+   iterator       end()          { return iterator(this, size());       }
+   const_iterator begin()  const { return const_iterator(this, 0);      }
+   const_iterator end()    const { return const_iterator(this, size()); }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+
+   //
+   // Access
+   //
+
+   reference operator [] (size_t index)
+   {
+      return row(index, std::index_sequence_for<Ts...>());
+   }
+   const_reference operator [] (size_t index) const
+   {
+      return row(index, std::index_sequence_for<Ts...>());
+   }
+
+   // one field of one row
+   template <size_t I>
+   column_type<I> & get(size_t index)             { return std::get<I>(columns)[index]; }
+   template <size_t I>
+   const column_type<I> & get(size_t index) const { return std::get<I>(columns)[index]; }
+
+   // a whole field, as one contiguous array
+   template <size_t I>
+   span<column_type<I>> column()
+   {
+      return span<column_type<I>>(empty() ? nullptr : &std::get<I>(columns)[0], size());
+   }
+   template <size_t I>
+   span<const column_type<I>> column() const
+   {
+      return span<const column_type<I>>(empty() ? nullptr : &std::get<I>(columns)[0], size());
+   }
+
+   //
+   // Insert
+   //
+
+   void push_back(const value_type & t) { append(t, std::integral_constant<size_t, 0>()); }
+   void push_back(value_type && t)      { append(std::move(t), std::integral_constant<size_t, 0>()); }
+   template <class ... Args>
+   void emplace_back(Args && ... args);
+   void reserve(size_t newCapacity);
+
+   //
+   // Remove
+   //
+
+   void clear()    { each([](auto & col) { col.clear(); }); }
+   void pop_back() { each([](auto & col) { col.pop_back(); }); }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return std::get<0>(columns).size();     }
+   size_t capacity() const { return std::get<0>(columns).capacity(); }
+   bool   empty()    const { return size() == 0;                     }
+
+private:
+   template <size_t ... Is>
+   reference row(size_t index, std::index_sequence<Is...>)
+   {
+      return reference(std::get<Is>(columns)[index]...);
+   }
+   template <size_t ... Is>
+   const_reference row(size_t index, std::index_sequence<Is...>) const
+   {
+      return const_reference(std::get<Is>(columns)[index]...);
+   }
+
+   template <class Tuple, size_t I>
+   void append(Tuple && t, std::integral_constant<size_t, I>);
+   template <class Tuple>
+   void append(Tuple &&, std::integral_constant<size_t, sizeof...(Ts)>) { }
+
+   template <class F>
+   void each(F f) { each(f, std::index_sequence_for<Ts...>()); }
+   template <class F, size_t ... Is>
+   void each(F f, std::index_sequence<Is...>)
+   {
+      int unused[] = { (f(std::get<Is>(columns)), 0)... };
+      (void)unused;
+   }
+
+   std::tuple<vector<Ts>...> columns;   // one vector per field
+};
+
+/**************************************************
+ * SOA VECTOR ITERATOR
+ * Walks the rows.  There is no row object in memory
+ * to point at, so dereferencing builds a tuple of
+ * references to the fields: read and write through
+ * it like a struct, or std::get<I> one field out.
+ * V is soa_vector for iterator and const soa_vector
+ * for const_iterator
+ *************************************************/
+template <typename ... Ts>
+template <typename V>
+class soa_vector <Ts...> :: basic_iterator
+{
+   template <typename VV>
+   friend class basic_iterator;
+   friend class ::TestSoaVector;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef std::tuple<Ts...>               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef void                            pointer;
+   typedef typename std::conditional<std::is_const<V>::value,
+                                     std::tuple<const Ts &...>,
+                                     std::tuple<Ts &...>>::type reference;
+
+   basic_iterator() : pv(nullptr), index(0) { }
+   basic_iterator(V * pv, size_t index) : pv(pv), index(index) { }
+
+   // an iterator converts to a const_iterator, never the other way
+   template <typename VV, typename = typename std::enable_if<
+      std::is_same<const VV, V>::value && !std::is_same<VV, V>::value>::type>
+   basic_iterator(const basic_iterator<VV> & rhs) : pv(rhs.pv), index(rhs.index) { }
+
+   friend bool operator == (const basic_iterator & lhs, const basic_iterator & rhs) { return lhs.index == rhs.index; }
+   friend bool operator != (const basic_iterator & lhs, const basic_iterator & rhs) { return lhs.index != rhs.index; }
+   friend bool operator <  (const basic_iterator & lhs, const basic_iterator & rhs) { return lhs.index <  rhs.index; }
+   friend bool operator >  (const basic_iterator & lhs, const basic_iterator & rhs) { return lhs.index >  rhs.index; }
+   friend bool operator <= (const basic_iterator & lhs, const basic_iterator & rhs) { return lhs.index <= rhs.index; }
+   friend bool operator >= (const basic_iterator & lhs, const basic_iterator & rhs) { return lhs.index >= rhs.index; }
+
+   reference operator * () const                   { return (*pv)[index];     }
+   reference operator [] (difference_type n) const { return (*pv)[index + n]; }
+
+   basic_iterator & operator ++ ()    { ++index; return *this; }
+   basic_iterator   operator ++ (int) { basic_iterator tmp = *this; ++index; return tmp; }
+   basic_iterator & operator -- ()    { --index; return *this; }
+   basic_iterator   operator -- (int) { basic_iterator tmp = *this; --index; return tmp; }
+   basic_iterator & operator += (difference_type n) { index += n; return *this; }
+   basic_iterator & operator -= (difference_type n) { index -= n; return *this; }
+
+   friend basic_iterator operator + (basic_iterator it, difference_type n) { return it += n; }
+   friend basic_iterator operator + (difference_type n, basic_iterator it) { return it += n; }
+   friend basic_iterator operator - (basic_iterator it, difference_type n) { return it -= n; }
+
+   // how many rows apart two iterators are
+   friend difference_type operator - (const basic_iterator & lhs, const basic_iterator & rhs)
+   {
+      return (difference_type)lhs.index - (difference_type)rhs.index;
+   }
+
+private:
+   V * pv;
+   size_t index;
+};
+
+/***************************************
+ * SOA VECTOR :: EMPLACE BACK
+ * Add a row, building field I from args[I]
+ *     INPUT  : one constructor argument per column
+ **************************************/
+template <typename ... Ts>
+template <class ... Args>
+void soa_vector <Ts...> :: emplace_back(Args && ... args)
+{
+   static_assert(sizeof...(Args) == sizeof...(Ts),
+                 "soa_vector::emplace_back takes one argument per column");
+   append(std::forward_as_tuple(std::forward<Args>(args)...),
+          std::integral_constant<size_t, 0>());
+}
+
+/***************************************
+ * SOA VECTOR :: RESERVE
+ * Make room for newCapacity rows in every column
+ **************************************/
+template <typename ... Ts>
+void soa_vector <Ts...> :: reserve(size_t newCapacity)
+{
+   each([newCapacity](auto & col) { col.reserve(newCapacity); });
+}
+
+/***************************************
+ * SOA VECTOR :: APPEND
+ * Push field I of t onto column I, then the rest.
+ * If a later column throws, take this one back off
+ * so the columns never disagree about the size
+ *     INPUT  : a tuple with one value per column
+ **************************************/
+template <typename ... Ts>
+template <class Tuple, size_t I>
+void soa_vector <Ts...> :: append(Tuple && t, std::integral_constant<size_t, I>)
+{
+   std::get<I>(columns).emplace_back(std::get<I>(std::forward<Tuple>(t)));
+   try
+   {
+      append(std::forward<Tuple>(t), std::integral_constant<size_t, I + 1>());
+   }
+   catch (...)
+   {
+      std::get<I>(columns).pop_back();
+      throw;
+   }
+}
+
+} // namespace custom
@@ -0,0 +1,451 @@
+/***********************************************************************
+ * Header:
+ *    STABLE VECTOR
+ * Summary:
+ *    A vector that never moves its elements.  Instead of one buffer
+ *    that is copied every time it doubles, it keeps a list of blocks
+ *    that double in size: 8, 16, 32, ... elements.  Growing just adds
+ *    the next block, so pointers and references to elements stay
+ *    good for as long as the element is there.
+ *
+ *    Finding element i is still O(1): which block it is in is the
+ *    position of the highest set bit of i + 8.
+ *
+ *    This will contain the class definition of:
+ *        segment                : Where index i lives in doubling blocks
+ *        stable_vector          : A segmented vector with stable addresses
+ *        stable_vector::iterator: A random-access iterator by index
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <cstddef>  // for size_t and std::ptrdiff_t
+#include <iterator> // for std::random_access_iterator_tag
+#include <memory>   // for std::allocator
+#include <new>      // for std::bad_alloc
+#include <utility>  // for std::move
+#include <initializer_list>
+#ifdef _MSC_VER
+#include <intrin.h> // for _BitScanReverse
+#endif
+
+class TestStableVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SEGMENT
+ * Block k holds firstBlock << k elements, so the
+ * first k blocks together hold firstBlock * (2^k - 1).
+ * Shared by every container built on doubling blocks
+ ****************************************/
+struct segment
+{
+   static const size_t firstBlockLog = 3;
+   static const size_t firstBlock = (size_t)1 << firstBlockLog;
+
+   // enough blocks to cover every index a size_t can hold
+   static const size_t maxBlocks = sizeof(size_t) * 8 - firstBlockLog;
+
+   // position of the highest set bit: n > 0
+   static size_t highBit(size_t n)
+   {
+      assert(n > 0);
+#if defined(__GNUC__)
+      return 63 - (size_t)__builtin_clzll((unsigned long long)n);
+#elif defined(_MSC_VER) && defined(_WIN64)
+      unsigned long bit;
+      _BitScanReverse64(&bit, n);
+      return bit;
+#else
+      size_t bit = 0;
+      while (n >>= 1)
+         bit++;
+      return bit;
+#endif
+   }
+
+   static size_t block(size_t index)    { return highBit(index + firstBlock) - firstBlockLog; }
+   static size_t offset(size_t index)   { return index - blockStart(block(index)); }
+   static size_t blockSize(size_t k)    { return firstBlock << k; }
+   static size_t blockStart(size_t k)   { return (firstBlock << k) - firstBlock; }
+};
+
+/*****************************************
+ * STABLE VECTOR
+ * Elements [0, numElements) are live.  Blocks are
+ * only added, never moved, and stay allocated until
+ * shrink_to_fit or the destructor
+ ****************************************/
+template <typename T, typename A = std::allocator<T>>
+class stable_vector
+{
+   friend class ::TestStableVector; // give unit tests access to the privates
+public:
+   typedef T value_type;
+   typedef A allocator_type;
+
+   //
+   // Construct
+   //
+
+   stable_vector(const A & a = A());
+   stable_vector(size_t num, const T & t, const A & a = A());
+   stable_vector(const std::initializer_list<T> & l, const A & a = A());
+   stable_vector(const stable_vector &  rhs);
+   stable_vector(      stable_vector && rhs) noexcept;
+   ~stable_vector();
+
+   //
+   // Assign
+   //
+
+   void swap(stable_vector & rhs) noexcept;
+   stable_vector & operator = (const stable_vector & rhs);
+   stable_vector & operator = (stable_vector && rhs) noexcept;
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() { return iterator(this, 0);           }
+   iterator end()   { return iterator(this, numElements); }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return at(index); }
+   const T & operator [] (size_t index) const { return const_cast<stable_vector *>(this)->at(index); }
+         T & front()       { return at(0); }
+   const T & front() const { return (*this)[0]; }
+         T & back()        { return at(numElements - 1); }
+   const T & back()  const { return (*this)[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+   template <class ... Args>
+   T & emplace_back(Args && ... args);
+   void reserve(size_t newCapacity);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      while (numElements > 0)
+         pop_back();
+   }
+   void pop_back()
+   {
+      if (numElements > 0)
+      {
+         --numElements;
+         traits::destroy(alloc, slot(numElements));
+      }
+   }
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements;                 }
+   size_t capacity() const { return segment::blockStart(numBlocks); }
+   bool   empty()    const { return numElements == 0;            }
+   A get_allocator() const { return alloc;                       }
+
+private:
+   typedef std::allocator_traits<A> traits;
+
+   T * slot(size_t index) const
+   {
+      return blocks[segment::block(index)] + segment::offset(index);
+   }
+   T & at(size_t index)
+   {
+      assert(index < numElements);
+      return *slot(index);
+   }
+   void addBlock();
+
+   A alloc;                             // hands out the blocks
+   T * blocks[segment::maxBlocks];      // block k holds blockSize(k) elements, null past numBlocks
+   size_t numBlocks;                    // how many blocks are allocated
+   size_t numElements;                  // the number of items currently used
+};
+
+/**************************************************
+ * STABLE VECTOR ITERATOR
+ * Remembers an index rather than a pointer, since
+ * the next element may be in another block
+ *************************************************/
+template <typename T, typename A>
+class stable_vector <T, A> :: iterator
+{
+   friend class ::TestStableVector;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   iterator() : pv(nullptr), index(0) { }
+   iterator(stable_vector * pv, size_t index) : pv(pv), index(index) { }
+
+   bool operator == (const iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const iterator & rhs) const { return index != rhs.index; }
+   bool operator <  (const iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const iterator & rhs) const { return index >= rhs.index; }
+
+   T & operator * () const                   { return (*pv)[index];     }
+   T * operator -> () const                  { return &(*pv)[index];    }
+   T & operator [] (difference_type n) const { return (*pv)[index + n]; }
+
+   iterator & operator ++ ()    { ++index; return *this; }
+   iterator   operator ++ (int) { iterator tmp = *this; ++index; return tmp; }
+   iterator & operator -- ()    { --index; return *this; }
+   iterator   operator -- (int) { iterator tmp = *this; --index; return tmp; }
+   iterator & operator += (difference_type n)       { index += n; return *this; }
+   iterator & operator -= (difference_type n)       { index -= n; return *this; }
+   iterator   operator +  (difference_type n) const { return iterator(pv, index + n); }
+   iterator   operator -  (difference_type n) const { return iterator(pv, index - n); }
+   difference_type operator - (const iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+
+private:
+   stable_vector * pv;
+   size_t index;
+};
+
+/*****************************************
+ * STABLE VECTOR :: DEFAULT constructor
+ * No blocks until the first push
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> :: stable_vector(const A & a) :
+   alloc(a), blocks(), numBlocks(0), numElements(0)
+{
+}
+
+/*****************************************
+ * STABLE VECTOR :: FILL constructor
+ * num copies of t
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> :: stable_vector(size_t num, const T & t, const A & a) :
+   alloc(a), blocks(), numBlocks(0), numElements(0)
+{
+   try
+   {
+      reserve(num);
+      for (size_t i = 0; i < num; i++)
+         push_back(t);
+   }
+   catch (...)
+   {
+      clear();
+      shrink_to_fit();
+      throw;
+   }
+}
+
+/*****************************************
+ * STABLE VECTOR :: INITIALIZE LIST constructor
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> :: stable_vector(const std::initializer_list<T> & l, const A & a) :
+   alloc(a), blocks(), numBlocks(0), numElements(0)
+{
+   try
+   {
+      reserve(l.size());
+      for (const T & t : l)
+         push_back(t);
+   }
+   catch (...)
+   {
+      clear();
+      shrink_to_fit();
+      throw;
+   }
+}
+
+/*****************************************
+ * STABLE VECTOR :: COPY CONSTRUCTOR
+ * Copy each element into blocks of our own
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> :: stable_vector(const stable_vector & rhs) :
+   alloc(traits::select_on_container_copy_construction(rhs.alloc)),
+   blocks(), numBlocks(0), numElements(0)
+{
+   try
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+         push_back(rhs[i]);
+   }
+   catch (...)
+   {
+      clear();
+      shrink_to_fit();
+      throw;
+   }
+}
+
+/*****************************************
+ * STABLE VECTOR :: MOVE CONSTRUCTOR
+ * Take rhs's blocks: the elements stay where they are
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> :: stable_vector(stable_vector && rhs) noexcept :
+   alloc(std::move(rhs.alloc)), blocks(), numBlocks(rhs.numBlocks), numElements(rhs.numElements)
+{
+   for (size_t k = 0; k < numBlocks; k++)
+   {
+      blocks[k] = rhs.blocks[k];
+      rhs.blocks[k] = nullptr;
+   }
+   rhs.numBlocks = 0;
+   rhs.numElements = 0;
+}
+
+/*****************************************
+ * STABLE VECTOR :: DESTRUCTOR
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> :: ~stable_vector()
+{
+   clear();
+   shrink_to_fit();
+}
+
+/*****************************************
+ * STABLE VECTOR :: SWAP
+ * Trade blocks with rhs.  Only the block lists
+ * move, the whole fixed-size array of them; no
+ * element does
+ ****************************************/
+template <typename T, typename A>
+void stable_vector <T, A> :: swap(stable_vector & rhs) noexcept
+{
+   std::swap(blocks, rhs.blocks);
+   std::swap(numBlocks, rhs.numBlocks);
+   std::swap(numElements, rhs.numElements);
+   if (traits::propagate_on_container_swap::value)
+      std::swap(alloc, rhs.alloc);
+}
+
+/*****************************************
+ * STABLE VECTOR :: ASSIGNMENT
+ * Copy-and-swap
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> & stable_vector <T, A> :: operator = (const stable_vector & rhs)
+{
+   if (this != &rhs)
+   {
+      stable_vector tmp(rhs);
+      swap(tmp);
+   }
+   return *this;
+}
+
+/*****************************************
+ * STABLE VECTOR :: MOVE ASSIGNMENT
+ ****************************************/
+template <typename T, typename A>
+stable_vector <T, A> & stable_vector <T, A> :: operator = (stable_vector && rhs) noexcept
+{
+   if (this != &rhs)
+   {
+      clear();
+      shrink_to_fit();
+      swap(rhs);
+   }
+   return *this;
+}
+
+/***************************************
+ * STABLE VECTOR :: EMPLACE BACK
+ * Build a new element at the end.  If the last
+ * block is full, add the next one: nothing moves
+ *     INPUT  : args for one of T's constructors
+ *     OUTPUT : the new element
+ **************************************/
+template <typename T, typename A>
+template <class ... Args>
+T & stable_vector <T, A> :: emplace_back(Args && ... args)
+{
+   if (numElements == capacity())
+      addBlock();
+   T * p = slot(numElements);
+   traits::construct(alloc, p, std::forward<Args>(args)...);
+   ++numElements;
+   return *p;
+}
+
+/***************************************
+ * STABLE VECTOR :: RESERVE
+ * Add blocks until newCapacity elements fit
+ **************************************/
+template <typename T, typename A>
+void stable_vector <T, A> :: reserve(size_t newCapacity)
+{
+   while (capacity() < newCapacity)
+      addBlock();
+}
+
+/***************************************
+ * STABLE VECTOR :: SHRINK TO FIT
+ * Give back the blocks past the last element
+ **************************************/
+template <typename T, typename A>
+void stable_vector <T, A> :: shrink_to_fit()
+{
+   size_t keep = numElements == 0 ? 0 : segment::block(numElements - 1) + 1;
+   while (numBlocks > keep)
+   {
+      --numBlocks;
+      traits::deallocate(alloc, blocks[numBlocks], segment::blockSize(numBlocks));
+      blocks[numBlocks] = nullptr;
+   }
+}
+
+/***************************************
+ * STABLE VECTOR :: ADD BLOCK
+ * Allocate the next block, twice the last one
+ **************************************/
+template <typename T, typename A>
+void stable_vector <T, A> :: addBlock()
+{
+   if (numBlocks == segment::maxBlocks)
+      throw std::bad_alloc();
+   blocks[numBlocks] = traits::allocate(alloc, segment::blockSize(numBlocks));
+   ++numBlocks;
+}
+
+/*****************************************
+ * SWAP
+ ****************************************/
+template <typename T, typename A>
+void swap(stable_vector <T, A> & lhs, stable_vector <T, A> & rhs) noexcept
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
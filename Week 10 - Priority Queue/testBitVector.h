@@ -0,0 +1,425 @@
+/***********************************************************************
+ * Header:
+ *    TEST BIT VECTOR
+ * Summary:
+ *    Unit tests for bit_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bit_vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <algorithm>
+
+class TestBitVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_fillTrue();
+      test_construct_initializerList();
+      test_constructCopy();
+      test_memory_oneBitEach();
+      test_memoryUsage_words();
+
+      // Assign
+      test_assign_keepsBuffer();
+      test_assign_shorterClearsTail();
+
+      // Access
+      test_subscript_writeThroughProxy();
+      test_subscript_proxyToProxy();
+
+      // Insert
+      test_pushback_crossesWord();
+      test_resize_shrinkClearsTail();
+
+      // Remove
+      test_popback_clearsBit();
+      test_shrink_releasesWords();
+
+      // Word-wide
+      test_count();
+      test_findFirst_none();
+      test_findNext_walk();
+      test_flip_keepsTailZero();
+      test_and();
+      test_or();
+      test_xor();
+
+      // Iterator
+      test_iterator_stdCount();
+      test_iterator_constFromIterator();
+      test_iterator_reverse();
+
+      report("BitVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no words
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::bit_vector<> v;
+      // verify
+      assertUnit(v.data == nullptr);
+      assertUnit(v.numWords == 0);
+      assertUnit(v.size() == 0);
+      assertUnit(v.begin() == v.end());
+   }  // teardown
+
+   // 100 trues take two words, and the 28 spare bits stay clear
+   void test_construct_fillTrue()
+   {  // setup
+      // exercise
+      custom::bit_vector<> v(100, true);
+      // verify
+      assertUnit(v.size() == 100);
+      assertUnit(v.numWords == 2);
+      assertUnit(v.capacity() == 128);
+      if (v.numWords == 2)
+      {
+         assertUnit(v.data[0] == ~uint64_t(0));
+         assertUnit(v.data[1] == (uint64_t(1) << 36) - 1);
+      }
+      assertUnit(v[99] == true);
+   }  // teardown
+
+   // {true, false, true}
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::bit_vector<> v{true, false, true};
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[0] == true);
+      assertUnit(v[1] == false);
+      assertUnit(v[2] == true);
+      assertUnit(v.data[0] == 5);
+   }  // teardown
+
+   // a copy has words of its own
+   void test_constructCopy()
+   {  // setup
+      custom::bit_vector<> vSrc(70, false);
+      vSrc[3] = true;
+      vSrc[69] = true;
+      // exercise
+      custom::bit_vector<> vDest(vSrc);
+      vSrc[3] = false;
+      // verify
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(vDest.size() == 70);
+      assertUnit(vDest[3] == true);
+      assertUnit(vDest[69] == true);
+      assertUnit(vDest.count() == 2);
+   }  // teardown
+
+   // a million flags fit in 125,000 bytes
+   void test_memory_oneBitEach()
+   {  // setup
+      // exercise
+      custom::bit_vector<> v(1000000);
+      // verify
+      assertUnit(v.numWords * sizeof(uint64_t) == 125000);
+      assertUnit(v.count() == 0);
+   }  // teardown
+
+   // memory_usage counts whole words
+   void test_memoryUsage_words()
+   {  // setup
+      custom::bit_vector<> v;
+      v.reserve(1000);
+      v.resize(65);
+      // exercise
+      custom::bit_vector<>::memory m = v.memory_usage();
+      // verify
+      assertUnit(m.reserved == 128);             // 16 words
+      assertUnit(m.used == 16);                  // 2 words
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assigning a smaller vector reuses the buffer
+   void test_assign_keepsBuffer()
+   {  // setup
+      custom::bit_vector<> vSrc(10, true);
+      custom::bit_vector<> vDest(200, false);
+      uint64_t * pWords = vDest.data;
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(vDest.data == pWords);
+      assertUnit(vDest.size() == 10);
+      assertUnit(vDest.count() == 10);
+   }  // teardown
+
+   // the flags past the new end are cleared, so count stays honest
+   void test_assign_shorterClearsTail()
+   {  // setup
+      custom::bit_vector<> vSrc(3, true);
+      custom::bit_vector<> vDest(200, true);
+      // exercise
+      vDest = vSrc;
+      vDest.resize(200);
+      // verify
+      assertUnit(vDest.count() == 3);
+      assertUnit(vDest[199] == false);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // the proxy sets and clears the right bit
+   void test_subscript_writeThroughProxy()
+   {  // setup
+      custom::bit_vector<> v(130);
+      // exercise
+      v[0] = true;
+      v[64] = true;
+      v[129] = true;
+      v[64] = false;
+      v[1].flip();
+      // verify
+      assertUnit(v.data[0] == 3);
+      assertUnit(v.data[1] == 0);
+      assertUnit(v.data[2] == 2);
+      assertUnit(v.front() == true);
+      assertUnit(v.back() == true);
+   }  // teardown
+
+   // assigning one proxy to another copies the value, not the reference
+   void test_subscript_proxyToProxy()
+   {  // setup
+      custom::bit_vector<> v{true, false};
+      // exercise
+      v[1] = v[0];
+      v[0] = false;
+      // verify
+      assertUnit(v[0] == false);
+      assertUnit(v[1] == true);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the 65th push needs a second word
+   void test_pushback_crossesWord()
+   {  // setup
+      custom::bit_vector<> v;
+      for (int i = 0; i < 64; i++)
+         v.push_back(i % 2 == 0);
+      assertUnit(v.numWords == 1);
+      // exercise
+      v.push_back(true);
+      // verify
+      assertUnit(v.numWords == 2);
+      assertUnit(v.size() == 65);
+      assertUnit(v[64] == true);
+      assertUnit(v.count() == 33);
+   }  // teardown
+
+   // shrinking clears the flags given up
+   void test_resize_shrinkClearsTail()
+   {  // setup
+      custom::bit_vector<> v(150, true);
+      // exercise
+      v.resize(70);
+      // verify
+      assertUnit(v.size() == 70);
+      assertUnit(v.count() == 70);
+      assertUnit(v.data[1] == (uint64_t(1) << 6) - 1);
+      assertUnit(v.data[2] == 0);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back leaves the bit it gave up clear
+   void test_popback_clearsBit()
+   {  // setup
+      custom::bit_vector<> v{false, true};
+      // exercise
+      v.pop_back();
+      v.push_back(false);
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(v[1] == false);
+      assertUnit(v.data[0] == 0);
+   }  // teardown
+
+   // shrink_to_fit keeps only the words in use
+   void test_shrink_releasesWords()
+   {  // setup
+      custom::bit_vector<> v;
+      v.reserve(1000);
+      v.push_back(true);
+      assertUnit(v.numWords == 16);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.numWords == 1);
+      assertUnit(v[0] == true);
+   }  // teardown
+
+   /***************************************
+    * WORD-WIDE
+    ***************************************/
+
+   // every third flag of 1000
+   void test_count()
+   {  // setup
+      custom::bit_vector<> v(1000);
+      for (size_t i = 0; i < 1000; i += 3)
+         v[i] = true;
+      // exercise
+      size_t num = v.count();
+      // verify
+      assertUnit(num == 334);
+   }  // teardown
+
+   // nothing set: find_first is size()
+   void test_findFirst_none()
+   {  // setup
+      custom::bit_vector<> v(300);
+      // exercise
+      size_t first = v.find_first();
+      // verify
+      assertUnit(first == 300);
+   }  // teardown
+
+   // walk the set flags, skipping whole clear words
+   void test_findNext_walk()
+   {  // setup
+      custom::bit_vector<> v(500);
+      v[7] = true;
+      v[63] = true;
+      v[64] = true;
+      v[400] = true;
+      size_t found[5] = {};
+      size_t num = 0;
+      // exercise
+      for (size_t i = v.find_first(); i < v.size() && num < 5; i = v.find_next(i + 1))
+         found[num++] = i;
+      // verify
+      assertUnit(num == 4);
+      assertUnit(found[0] == 7);
+      assertUnit(found[1] == 63);
+      assertUnit(found[2] == 64);
+      assertUnit(found[3] == 400);
+   }  // teardown
+
+   // flip inverts the live flags only
+   void test_flip_keepsTailZero()
+   {  // setup
+      custom::bit_vector<> v(70);
+      v[5] = true;
+      // exercise
+      v.flip();
+      // verify
+      assertUnit(v.count() == 69);
+      assertUnit(v[5] == false);
+      assertUnit(v.data[1] == (uint64_t(1) << 6) - 1);
+   }  // teardown
+
+   // {1,1,0,0} & {1,0,1,0} = {1,0,0,0}
+   void test_and()
+   {  // setup
+      custom::bit_vector<> vLeft{true, true, false, false};
+      custom::bit_vector<> vRight{true, false, true, false};
+      // exercise
+      vLeft &= vRight;
+      // verify
+      assertUnit(vLeft[0] == true);
+      assertUnit(vLeft[1] == false);
+      assertUnit(vLeft[2] == false);
+      assertUnit(vLeft[3] == false);
+   }  // teardown
+
+   // {1,1,0,0} | {1,0,1,0} = {1,1,1,0}
+   void test_or()
+   {  // setup
+      custom::bit_vector<> vLeft{true, true, false, false};
+      custom::bit_vector<> vRight{true, false, true, false};
+      // exercise
+      vLeft |= vRight;
+      // verify
+      assertUnit(vLeft[0] == true);
+      assertUnit(vLeft[1] == true);
+      assertUnit(vLeft[2] == true);
+      assertUnit(vLeft[3] == false);
+   }  // teardown
+
+   // {1,1,0,0} ^ {1,0,1,0} = {0,1,1,0}
+   void test_xor()
+   {  // setup
+      custom::bit_vector<> vLeft{true, true, false, false};
+      custom::bit_vector<> vRight{true, false, true, false};
+      // exercise
+      vLeft ^= vRight;
+      // verify
+      assertUnit(vLeft[0] == false);
+      assertUnit(vLeft[1] == true);
+      assertUnit(vLeft[2] == true);
+      assertUnit(vLeft[3] == false);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // std::count walks the proxies and agrees with count()
+   void test_iterator_stdCount()
+   {  // setup
+      custom::bit_vector<> v(200);
+      for (size_t i = 0; i < 200; i += 7)
+         v[i] = true;
+      // exercise
+      long num = (long)std::count(v.begin(), v.end(), true);
+      // verify
+      assertUnit(num == (long)v.count());
+      assertUnit(v.end() - v.begin() == 200);
+   }  // teardown
+
+   // an iterator converts to a const_iterator
+   void test_iterator_constFromIterator()
+   {  // setup
+      custom::bit_vector<> v{false, true};
+      custom::bit_vector<>::iterator it = v.begin() + 1;
+      // exercise
+      custom::bit_vector<>::const_iterator itConst = it;
+      *it = false;
+      // verify
+      assertUnit(*itConst == false);
+      assertUnit(itConst == v.cbegin() + 1);
+   }  // teardown
+
+   // rbegin starts at the last flag
+   void test_iterator_reverse()
+   {  // setup
+      custom::bit_vector<> v{true, false, false};
+      // exercise
+      custom::bit_vector<>::const_reverse_iterator it = v.crbegin();
+      // verify
+      assertUnit(*it == false);
+      assertUnit(*(v.crend() - 1) == true);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,280 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT VECTOR
+ * Summary:
+ *    Unit tests for concurrent_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/*************************************************************
+ * LIMITED ALLOCATOR
+ * A std::allocator that fails once *pBudget blocks have been
+ * handed out, so a test can run out of memory on demand
+ *************************************************************/
+template <typename T>
+struct LimitedAllocator
+{
+   typedef T value_type;
+   int * pBudget;
+   LimitedAllocator(int * pBudget) : pBudget(pBudget) {}
+   template <typename U>
+   LimitedAllocator(const LimitedAllocator<U> & rhs) : pBudget(rhs.pBudget) {}
+   T * allocate(size_t n)
+   {
+      if (*pBudget == 0)
+         throw std::bad_alloc();
+      (*pBudget)--;
+      return std::allocator<T>().allocate(n);
+   }
+   void deallocate(T * p, size_t n) { std::allocator<T>().deallocate(p, n); }
+   template <typename U>
+   bool operator == (const LimitedAllocator<U> & rhs) const { return pBudget == rhs.pBudget; }
+   template <typename U>
+   bool operator != (const LimitedAllocator<U> & rhs) const { return pBudget != rhs.pBudget; }
+};
+
+class TestConcurrentVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_destroysAll();
+
+      // Insert, one thread
+      test_pushback_returnsIndex();
+      test_pushback_addressesStable();
+      test_growby_default();
+      test_growby_copies();
+      test_pushback_allocFailsClaimsNothing();
+      test_emplaceback_throwClaimsNothing();
+
+      // Insert, many threads
+      test_pushback_threads();
+      test_growby_threadsContiguous();
+
+      report("ConcurrentVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no blocks
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::concurrent_vector<int> v;
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(v.blocks[0].load() == nullptr);
+   }  // teardown
+
+   // every element built is destroyed exactly once
+   void test_destructor_destroysAll()
+   {  // setup
+      {
+         custom::concurrent_vector<Spy> v;
+         v.grow_by(20, Spy(99));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 20);
+   }  // teardown
+
+   /***************************************
+    * INSERT, ONE THREAD
+    ***************************************/
+
+   // push_back tells you where the element went
+   void test_pushback_returnsIndex()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      // exercise
+      size_t i0 = v.push_back(26);
+      size_t i1 = v.push_back(49);
+      // verify
+      assertUnit(i0 == 0);
+      assertUnit(i1 == 1);
+      assertUnit(v.size() == 2);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+   }  // teardown
+
+   // elements stay put while the vector grows
+   void test_pushback_addressesStable()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      v.push_back(26);
+      int * p = &v[0];
+      // exercise
+      for (int i = 1; i < 10000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(&v[0] == p);
+      assertUnit(v[9999] == 9999);
+   }  // teardown
+
+   // grow_by value-initializes a run of elements
+   void test_growby_default()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      v.push_back(26);
+      // exercise
+      size_t first = v.grow_by(30);
+      // verify
+      assertUnit(first == 1);
+      assertUnit(v.size() == 31);
+      assertUnit(v[1] == 0);
+      assertUnit(v[30] == 0);
+   }  // teardown
+
+   // grow_by with a value copies it into each slot
+   void test_growby_copies()
+   {  // setup
+      custom::concurrent_vector<Spy> v;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      size_t first = v.grow_by(10, s);
+      // verify
+      assertUnit(first == 0);
+      assertUnit(Spy::numCopy() == 10);          // copy [99,99,...]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.size() == 10);
+      if (v.size() == 10)
+         assertUnit(v[9] == Spy(99));
+   }  // teardown
+
+   // running out of memory throws and leaves the size alone
+   void test_pushback_allocFailsClaimsNothing()
+   {  // setup
+      int budget = 1;
+      custom::concurrent_vector<int, LimitedAllocator<int>> v(LimitedAllocator<int>{&budget});
+      v.push_back(26);
+      while (v.size() < 8)                       // fill the first block
+         v.push_back(49);
+      bool threw = false;
+      // exercise
+      try
+      {
+         v.push_back(67);
+      }
+      catch (const std::bad_alloc &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(v.size() == 8);
+      assertUnit(v.blocks[1].load() == nullptr);
+      budget = 1;
+      assertUnit(v.push_back(89) == 8);
+      assertUnit(v[8] == 89);
+   }  // teardown
+
+   // an element that fails to build is never given an index
+   void test_emplaceback_throwClaimsNothing()
+   {  // setup
+      struct Picky
+      {
+         int value;
+         explicit Picky(int v) : value(v) { if (v < 0) throw std::invalid_argument("negative"); }
+         Picky(Picky && rhs) noexcept : value(rhs.value) {}
+      };
+      custom::concurrent_vector<Picky> v;
+      v.emplace_back(26);
+      bool threw = false;
+      // exercise
+      try
+      {
+         v.emplace_back(-1);
+      }
+      catch (const std::invalid_argument &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(v.size() == 1);
+      assertUnit(v.emplace_back(49) == 1);
+      assertUnit(v[1].value == 49);
+   }  // teardown
+
+   /***************************************
+    * INSERT, MANY THREADS
+    ***************************************/
+
+   // four producers: every value lands exactly once
+   void test_pushback_threads()
+   {  // setup
+      const int numThreads = 4;
+      const int perThread = 20000;
+      custom::concurrent_vector<int> v;
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&v, t, perThread]()
+         {
+            for (int i = 0; i < perThread; i++)
+               v.push_back(t * perThread + i);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(v.size() == numThreads * perThread);
+      std::vector<int> seen(numThreads * perThread, 0);
+      for (size_t i = 0; i < v.size(); i++)
+         seen[v[i]]++;
+      bool allOnce = true;
+      for (size_t i = 0; i < seen.size(); i++)
+         allOnce = allOnce && seen[i] == 1;
+      assertUnit(allOnce);
+   }  // teardown
+
+   // each grow_by gets a contiguous run no other thread touches
+   void test_growby_threadsContiguous()
+   {  // setup
+      const int numThreads = 4;
+      const int runs = 500;
+      const int runLength = 10;
+      custom::concurrent_vector<int> v;
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&v, t, runs, runLength]()
+         {
+            for (int r = 0; r < runs; r++)
+               v.grow_by(runLength, t);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(v.size() == numThreads * runs * runLength);
+      bool runsIntact = true;
+      for (size_t i = 0; i < v.size(); i += runLength)
+         for (size_t j = 1; j < (size_t)runLength; j++)
+            runsIntact = runsIntact && v[i + j] == v[i];
+      assertUnit(runsIntact);
+   }  // teardown
+};
+
+#endif // DEBUG
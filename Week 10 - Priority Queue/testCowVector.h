@@ -0,0 +1,294 @@
+/***********************************************************************
+ * Header:
+ *    TEST COW VECTOR
+ * Summary:
+ *    Unit tests for cow_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "cow_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+
+class TestCowVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeThree();
+      test_construct_fromVector();
+
+      // Copy
+      test_spy_constructCopyShares();
+      test_spy_assignShares();
+      test_spy_readSnapshotNoCopies();
+      test_constructMove();
+
+      // Detach
+      test_spy_subscriptWriteDetaches();
+      test_spy_pushbackDetaches();
+      test_spy_writeUnsharedNoCopies();
+      test_spy_clearSharedNoCopies();
+      test_spy_popbackDetaches();
+      test_subscript_boolDetaches();
+      test_referenceBeforeCopy_aliasesCopy();
+
+      // Iterator
+      test_iterator_constSum();
+
+      report("CowVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // an empty cow_vector has no buffer
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::cow_vector<int> v;
+      // verify
+      assertUnit(v.buffer == nullptr);
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(v.cbegin() == v.cend());
+   }  // teardown
+
+   // three default-constructed elements
+   void test_construct_sizeThree()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::cow_vector<Spy> v(3);
+      // verify
+      assertUnit(Spy::numDefault() == 3);        // default [  ,  ,  ]
+      assertUnit(v.size() == 3);
+      assertUnit(v.use_count() == 1);
+   }  // teardown
+
+   // adopt an existing vector's buffer without copying it
+   void test_construct_fromVector()
+   {  // setup
+      custom::vector<Spy> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::cow_vector<Spy> v(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.size() == 2);
+      assertUnit(vSrc.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * COPY
+    ***************************************/
+
+   // a copy shares the buffer: no element is touched
+   void test_spy_constructCopyShares()
+   {  // setup
+      custom::cow_vector<Spy> vSrc(4, Spy(99));
+      Spy::reset();
+      // exercise
+      custom::cow_vector<Spy> vDest(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(vDest.buffer == vSrc.buffer);
+      assertUnit(vDest.use_count() == 2);
+      assertUnit(vDest.size() == 4);
+   }  // teardown
+
+   // assignment shares too, and lets go of the old buffer
+   void test_spy_assignShares()
+   {  // setup
+      custom::cow_vector<Spy> vSrc(4, Spy(99));
+      custom::cow_vector<Spy> vDest(2, Spy(26));
+      Spy::reset();
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDestructor() == 2);     // destroy [26,26]
+      assertUnit(vDest.buffer == vSrc.buffer);
+   }  // teardown
+
+   // a snapshot that is only read never copies anything
+   void test_spy_readSnapshotNoCopies()
+   {  // setup
+      custom::cow_vector<Spy> vLive;
+      for (int i = 0; i < 100; i++)
+         vLive.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      const custom::cow_vector<Spy> vSnapshot(vLive);
+      int sum = 0;
+      for (custom::cow_vector<Spy>::const_iterator it = vSnapshot.begin(); it != vSnapshot.end(); ++it)
+         sum += it->get();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(sum == 4950);
+      assertUnit(vSnapshot[99] == Spy(99));
+      assertUnit(vSnapshot.use_count() == 2);
+   }  // teardown
+
+   // moving steals the buffer
+   void test_constructMove()
+   {  // setup
+      custom::cow_vector<int> vSrc{26, 49};
+      custom::vector<int> * pBuffer = vSrc.buffer.get();
+      // exercise
+      custom::cow_vector<int> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vDest.buffer.get() == pBuffer);
+      assertUnit(vDest.use_count() == 1);
+      assertUnit(vSrc.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * DETACH
+    ***************************************/
+
+   // writing through a shared copy clones the buffer once
+   void test_spy_subscriptWriteDetaches()
+   {  // setup
+      custom::cow_vector<Spy> vSrc(4, Spy(99));
+      custom::cow_vector<Spy> vDest(vSrc);
+      Spy::reset();
+      // exercise
+      vDest[0] = Spy(26);
+      vDest[1] = Spy(49);
+      // verify
+      assertUnit(Spy::numCopy() == 4);           // clone [99,99,99,99]
+      assertUnit(vDest.buffer != vSrc.buffer);
+      assertUnit(vSrc.use_count() == 1);
+      assertUnit(vDest[0] == Spy(26));
+      const custom::cow_vector<Spy> & cSrc = vSrc;
+      assertUnit(cSrc[0] == Spy(99));
+   }  // teardown
+
+   // push_back on a shared copy leaves the other copy alone
+   void test_spy_pushbackDetaches()
+   {  // setup
+      custom::cow_vector<int> vSrc{26, 49};
+      custom::cow_vector<int> vDest(vSrc);
+      // exercise
+      vDest.push_back(67);
+      // verify
+      assertUnit(vDest.size() == 3);
+      assertUnit(vSrc.size() == 2);
+      assertUnit(vSrc.use_count() == 1);
+      assertUnit(vDest.use_count() == 1);
+   }  // teardown
+
+   // a buffer nobody else holds is written in place
+   void test_spy_writeUnsharedNoCopies()
+   {  // setup
+      custom::cow_vector<Spy> v(4, Spy(99));
+      custom::vector<Spy> * pBuffer = v.buffer.get();
+      Spy::reset();
+      // exercise
+      v[0] = Spy(26);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v.buffer.get() == pBuffer);
+   }  // teardown
+
+   // clearing a shared copy drops it without cloning
+   void test_spy_clearSharedNoCopies()
+   {  // setup
+      custom::cow_vector<Spy> vSrc(4, Spy(99));
+      custom::cow_vector<Spy> vDest(vSrc);
+      Spy::reset();
+      // exercise
+      vDest.clear();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(vDest.empty());
+      assertUnit(vSrc.size() == 4);
+      assertUnit(vSrc.use_count() == 1);
+   }  // teardown
+
+   // pop_back is a write, so a shared copy detaches first
+   void test_spy_popbackDetaches()
+   {  // setup
+      custom::cow_vector<int> vSrc{26, 49, 67};
+      custom::cow_vector<int> vDest(vSrc);
+      // exercise
+      vDest.pop_back();
+      // verify
+      assertUnit(vDest.size() == 2);
+      assertUnit(vSrc.size() == 3);
+   }  // teardown
+
+   // flags detach like anything else
+   void test_subscript_boolDetaches()
+   {  // setup
+      custom::cow_vector<bool> vSrc{ true, false };
+      custom::cow_vector<bool> vDest(vSrc);
+      // exercise
+      bool & b = vDest[1];
+      b = true;
+      // verify
+      const custom::cow_vector<bool> & cSrc = vSrc;
+      assertUnit(vDest.buffer != vSrc.buffer);
+      assertUnit(cSrc[1] == false);
+      assertUnit(vDest.back() == true);
+   }  // teardown
+
+   // a reference taken before the copy still reaches the shared
+   // buffer: this pins the hazard documented in cow_vector.h
+   void test_referenceBeforeCopy_aliasesCopy()
+   {  // setup
+      custom::cow_vector<int> vSrc{26, 49, 67};
+      int & first = vSrc[0];
+      custom::cow_vector<int> vDest(vSrc);
+      // exercise
+      first = 99;
+      // verify
+      const custom::cow_vector<int> & cDest = vDest;
+      assertUnit(vDest.buffer == vSrc.buffer);
+      assertUnit(cDest[0] == 99);
+      // exercise: taking the reference again detaches vSrc
+      vSrc[0] = 11;
+      // verify
+      assertUnit(vDest.buffer != vSrc.buffer);
+      assertUnit(cDest[0] == 99);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // cbegin and cend read without detaching
+   void test_iterator_constSum()
+   {  // setup
+      custom::cow_vector<int> vSrc{26, 49, 67, 89};
+      custom::cow_vector<int> vDest(vSrc);
+      int sum = 0;
+      // exercise
+      for (custom::cow_vector<int>::const_iterator it = vDest.cbegin(); it != vDest.cend(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertUnit(vDest.buffer == vSrc.buffer);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,430 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAPPED VECTOR
+ * Summary:
+ *    Unit tests for mapped_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mapped_vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdio>      // for std::remove
+#include <fstream>     // for writing bad files and measuring good ones
+#include <stdexcept>
+
+class TestMappedVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_newFile();
+      test_construct_reopen();
+      test_construct_wrongType();
+      test_construct_notOurs();
+      test_construct_tooSmall();
+      test_constructMove();
+
+      // Insert
+      test_pushback_grows();
+      test_pushback_afterReopen();
+      test_reserve();
+      test_resize_bigger();
+      test_reserve_failKeepsMapping();
+#ifndef _WIN32
+      test_reserve_failClosesFile();
+#endif
+
+      // Remove
+      test_popback();
+      test_clear_trimsFile();
+
+      // Iterator
+      test_iterator_sum();
+
+      report("MappedVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // a new file holds only the header
+   void test_construct_newFile()
+   {  // setup
+      std::remove(path);
+      {
+         // exercise
+         custom::mapped_vector<Record> v(path);
+         // verify
+         assertUnit(v.numCapacity == 0);
+         assertUnit(v.size() == 0);
+         assertUnit(v.header->magic == custom::mapped_vector<Record>::magic);
+         assertUnit(v.header->elementSize == sizeof(Record));
+      }
+      assertUnit(fileSize() == 64);
+      // teardown
+      std::remove(path);
+   }
+
+   // reopening hands back the elements, with the file trimmed to fit
+   void test_construct_reopen()
+   {  // setup
+      std::remove(path);
+      {
+         custom::mapped_vector<Record> v(path);
+         v.push_back(Record{26, 2.6});
+         v.push_back(Record{49, 4.9});
+         v.push_back(Record{67, 6.7});
+      }
+      // exercise
+      custom::mapped_vector<Record> v(path);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v.numCapacity == 3);
+      assertUnit(v[0].id == 26);
+      assertUnit(v[1].id == 49);
+      assertUnit(v[2].id == 67);
+      assertUnit(v[2].value == 6.7);
+      assertUnit(fileSize() == 64 + 3 * sizeof(Record));
+      // teardown
+      std::remove(path);
+   }
+
+   // a file of ints cannot be opened as a file of Records
+   void test_construct_wrongType()
+   {  // setup
+      std::remove(path);
+      {
+         custom::mapped_vector<int> v(path);
+         v.push_back(99);
+      }
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mapped_vector<Record> v(path);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      // teardown
+      std::remove(path);
+   }
+
+   // some other file altogether is refused
+   void test_construct_notOurs()
+   {  // setup
+      std::remove(path);
+      {
+         std::ofstream fout(path, std::ios::binary);
+         for (int i = 0; i < 100; i++)
+            fout.put('x');
+      }
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mapped_vector<int> v(path);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      // teardown
+      std::remove(path);
+   }
+
+   // a file shorter than the header is refused
+   void test_construct_tooSmall()
+   {  // setup
+      std::remove(path);
+      {
+         std::ofstream fout(path, std::ios::binary);
+         fout.put('x');
+      }
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mapped_vector<int> v(path);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      // teardown
+      std::remove(path);
+   }
+
+   // moving takes over the mapping
+   void test_constructMove()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> vSrc(path);
+      vSrc.push_back(26);
+      vSrc.push_back(49);
+      int * pSrc = vSrc.data;
+      // exercise
+      custom::mapped_vector<int> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vDest.data == pSrc);
+      assertUnit(vDest.size() == 2);
+      assertUnit(vDest[1] == 49);
+      assertUnit(vSrc.data == nullptr);
+      assertUnit(vSrc.size() == 0);
+      // teardown
+      std::remove(path);
+   }
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back doubles the file: 1, 2, 4, 8
+   void test_pushback_grows()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(i * 10);
+      // verify
+      assertUnit(v.size() == 5);
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.header->count == 5);
+      assertUnit(v[0] == 0);
+      assertUnit(v[4] == 40);
+      assertUnit(fileSize() == 64 + 8 * sizeof(int));
+      // teardown
+      std::remove(path);
+   }
+
+   // appending to a reopened file grows it
+   void test_pushback_afterReopen()
+   {  // setup
+      std::remove(path);
+      {
+         custom::mapped_vector<int> v(path);
+         v.push_back(26);
+         v.push_back(49);
+      }
+      {
+         custom::mapped_vector<int> v(path);
+         // exercise
+         v.push_back(67);
+         v.push_back(v[0]);
+      }
+      // verify
+      custom::mapped_vector<int> v(path);
+      assertUnit(v.size() == 4);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 67);
+      assertUnit(v[3] == 26);
+      // teardown
+      std::remove(path);
+   }
+
+   // reserve grows the file but not the size
+   void test_reserve()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      // exercise
+      v.reserve(100);
+      // verify
+      assertUnit(v.numCapacity == 100);
+      assertUnit(v.size() == 1);
+      assertUnit(v[0] == 26);
+      assertUnit(fileSize() == 64 + 100 * sizeof(int));
+      // teardown
+      std::remove(path);
+   }
+
+   // new elements from resize are zero
+   void test_resize_bigger()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<Record> v(path);
+      v.push_back(Record{26, 2.6});
+      // exercise
+      v.resize(3);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[0].id == 26);
+      assertUnit(v[1].id == 0);
+      assertUnit(v[2].id == 0);
+      assertUnit(v[2].value == 0.0);
+      // teardown
+      std::remove(path);
+   }
+
+   // a file that cannot grow is mapped again at its old size
+   void test_reserve_failKeepsMapping()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      v.push_back(49);
+      bool thrown = false;
+      // exercise: more bytes than a file offset can hold
+      try
+      {
+         v.reserve((size_t)1 << 61);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(v.header != nullptr);
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.size() == 2);
+      assertUnit(v[1] == 49);
+      v.push_back(67);
+      assertUnit(v.size() == 3);
+      assertUnit(v[2] == 67);
+      // teardown
+      std::remove(path);
+   }
+
+#ifndef _WIN32
+   // when the old mapping cannot come back either, the file is
+   // closed and the vector is left empty rather than dangling
+   void test_reserve_failClosesFile()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      ::close(v.fd);
+      v.fd = ::open(path, O_RDONLY);   // can neither grow nor map for writing
+      int fdReadOnly = v.fd;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         v.reserve(100);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(v.header == nullptr);
+      assertUnit(v.fd == -1);
+      assertUnit(fcntl(fdReadOnly, F_GETFD) == -1);   // released, not leaked
+      assertUnit(v.empty());
+      assertUnit(v.numCapacity == 0);
+      thrown = false;
+      try
+      {
+         v.push_back(49);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      assertUnit(thrown);
+      // teardown
+      std::remove(path);
+   }
+#endif
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back only changes the count
+   void test_popback()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.size() == 1);
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.back() == 26);
+      // teardown
+      std::remove(path);
+   }
+
+   // a cleared vector leaves just the header behind
+   void test_clear_trimsFile()
+   {  // setup
+      std::remove(path);
+      {
+         custom::mapped_vector<int> v(path);
+         v.push_back(26);
+         v.push_back(49);
+         // exercise
+         v.clear();
+      }
+      // verify
+      assertUnit(fileSize() == 64);
+      custom::mapped_vector<int> v(path);
+      assertUnit(v.empty());
+      // teardown
+      std::remove(path);
+   }
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk the elements
+   void test_iterator_sum()
+   {  // setup
+      std::remove(path);
+      custom::mapped_vector<int> v(path);
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      v.push_back(89);
+      int sum = 0;
+      // exercise
+      for (custom::mapped_vector<int>::iterator it = v.begin(); it != v.end(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      // teardown
+      std::remove(path);
+   }
+
+private:
+   struct Record
+   {
+      int id;
+      double value;
+   };
+
+   const char * path = "testMappedVector.tmp";
+
+   size_t fileSize()
+   {
+      std::ifstream fin(path, std::ios::binary | std::ios::ate);
+      return fin ? (size_t)fin.tellg() : 0;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,195 @@
+/***********************************************************************
+ * Header:
+ *    TEST MMAP ALLOCATOR
+ * Summary:
+ *    Unit tests for mmap_allocator and vector's in-place growth
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mmap_allocator.h"
+#include "vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+
+class TestMmapAllocator : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_aligned();
+      test_allocate_reservesDefault();
+      test_allocate_bigRequest();
+
+      // Expand
+      test_expand_withinReservation();
+      test_expand_pastReservation();
+
+      // Vector
+      test_pushback_growsInPlace();
+      test_reserve_growsInPlace();
+      test_spy_pushbackNoMoves();
+      test_pushback_outgrowsReservation();
+
+      report("MmapAllocator");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // buffers start on a huge page boundary
+   void test_allocate_aligned()
+   {  // setup
+      custom::mmap_allocator<int> a;
+      // exercise
+      int * p = a.allocate(4);
+      // verify
+      assertUnit(p != nullptr);
+      assertUnit(reinterpret_cast<uintptr_t>(p) % a.hugePage == 0);
+      // teardown
+      a.deallocate(p, 4);
+   }
+
+   // a small request still reserves the full default region
+   void test_allocate_reservesDefault()
+   {  // setup
+      custom::mmap_allocator<int> a(4 * 1024 * 1024);
+      // exercise
+      size_t bytes = a.reservationFor(4);
+      // verify
+      assertUnit(a.reserveBytes == 4 * 1024 * 1024);
+      assertUnit(bytes == 4 * 1024 * 1024);
+   }  // teardown
+
+   // a request bigger than the default gets a region of its own size
+   void test_allocate_bigRequest()
+   {  // setup
+      custom::mmap_allocator<int> a(custom::mmap_allocator<int>::hugePage);
+      // exercise
+      size_t bytes = a.reservationFor(a.hugePage);  // 4 bytes each
+      // verify
+      assertUnit(bytes == 4 * a.hugePage);
+   }  // teardown
+
+   /***************************************
+    * EXPAND
+    ***************************************/
+
+   // growing inside the reservation keeps the same pointer and the data
+   void test_expand_withinReservation()
+   {  // setup
+      custom::mmap_allocator<int> a(custom::mmap_allocator<int>::hugePage);
+      int * p = a.allocate(4);
+      p[0] = 26;
+      p[3] = 89;
+      // exercise
+      bool expanded = a.expand(p, 4, 1000);
+      // verify
+      assertUnit(expanded);
+      assertUnit(p[0] == 26);
+      assertUnit(p[3] == 89);
+      p[999] = 99;                               // the new room is writable
+      assertUnit(p[999] == 99);
+      // teardown
+      a.deallocate(p, 1000);
+   }
+
+   // growing past the reservation is refused
+   void test_expand_pastReservation()
+   {  // setup
+      custom::mmap_allocator<int> a(custom::mmap_allocator<int>::hugePage);
+      int * p = a.allocate(4);
+      // exercise
+      bool expanded = a.expand(p, 4, a.hugePage);  // 4 huge pages of int
+      // verify
+      assertUnit(!expanded);
+      // teardown
+      a.deallocate(p, 4);
+   }
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // every push_back after the first allocation grows in place
+   void test_pushback_growsInPlace()
+   {  // setup
+      custom::vector<int, custom::mmap_allocator<int>> v;
+      v.push_back(0);
+      int * p = v.data;
+      // exercise
+      for (int i = 1; i < 100000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.data == p);
+      assertUnit(v.numElements == 100000);
+      assertUnit(v.numCapacity == 131072);
+      assertUnit(v[0] == 0);
+      assertUnit(v[99999] == 99999);
+   }  // teardown
+
+   // reserve also grows in place
+   void test_reserve_growsInPlace()
+   {  // setup
+      custom::vector<int, custom::mmap_allocator<int>> v{26, 49};
+      int * p = v.data;
+      // exercise
+      v.reserve(1000);
+      // verify
+      assertUnit(v.data == p);
+      assertUnit(v.numCapacity == 1000);
+      assertUnit(v.numElements == 2);
+      assertUnit(v[1] == 49);
+   }  // teardown
+
+   // in-place growth neither copies nor moves the existing elements
+   void test_spy_pushbackNoMoves()
+   {  // setup
+      custom::vector<Spy, custom::mmap_allocator<Spy>> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);           // copy [67]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+         assertUnit(v[2] == Spy(67));
+   }  // teardown
+
+   // once the reservation is full, vector falls back to moving
+   void test_pushback_outgrowsReservation()
+   {  // setup
+      custom::mmap_allocator<int> a(custom::mmap_allocator<int>::hugePage);
+      custom::vector<int, custom::mmap_allocator<int>> v(a);
+      size_t full = a.hugePage / sizeof(int);
+      v.reserve(full);
+      for (size_t i = 0; i < full; i++)
+         v.push_back((int)i);
+      int * p = v.data;
+      // exercise
+      v.push_back(99);
+      // verify
+      assertUnit(v.data != p);
+      assertUnit(v.numCapacity == full * 2);
+      assertUnit(v.numElements == full + 1);
+      assertUnit(v[0] == 0);
+      assertUnit(v[full - 1] == (int)full - 1);
+      assertUnit(v[full] == 99);
+   }  // teardown
+};
+
+#endif // DEBUG
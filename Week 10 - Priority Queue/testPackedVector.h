@@ -0,0 +1,276 @@
+/***********************************************************************
+ * Header:
+ *    TEST PACKED VECTOR
+ * Summary:
+ *    Unit tests for packed_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "packed_vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <stdexcept>
+
+class TestPackedVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_construct_range();
+
+      // Pack
+      test_pack_frameWidth();
+      test_pack_deltaWidth();
+      test_pack_allEqualTakesNoWords();
+      test_pack_fullWidth();
+
+      // Access
+      test_subscript_frame();
+      test_subscript_delta();
+      test_decode_straddlesBlocks();
+      test_pushback_deltaDecreasingThrows();
+
+      // Iterator
+      test_iterator_sum();
+
+      // Memory
+      test_memory_sortedIds();
+
+      report("PackedVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing packed
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::packed_vector v;
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(v.blocks.size() == 0);
+      assertUnit(v.get_encoding() == custom::packed_vector::frame);
+      assertUnit(v.begin() == v.end());
+   }  // teardown
+
+   // a short list stays in the unpacked tail
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::packed_vector v{26, 49, 67};
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v.numTail == 3);
+      assertUnit(v.blocks.size() == 0);
+      assertUnit(v[0] == 26);
+      assertUnit(v.back() == 67);
+   }  // teardown
+
+   // 300 values make two packed blocks and a tail of 44
+   void test_construct_range()
+   {  // setup
+      uint64_t values[300];
+      for (size_t i = 0; i < 300; i++)
+         values[i] = 1000000 + i * 3;
+      // exercise
+      custom::packed_vector v(values, values + 300, custom::packed_vector::delta);
+      // verify
+      assertUnit(v.size() == 300);
+      assertUnit(v.blocks.size() == 2);
+      assertUnit(v.numPacked == 256);
+      assertUnit(v.numTail == 44);
+      assertUnit(v[299] == 1000000 + 299 * 3);
+   }  // teardown
+
+   /***************************************
+    * PACK
+    ***************************************/
+
+   // frame: 128 values spanning 0..127 above the base need 7 bits
+   void test_pack_frameWidth()
+   {  // setup
+      custom::packed_vector v;
+      // exercise
+      for (uint64_t i = 0; i < 128; i++)
+         v.push_back(5000000 + (i * 37) % 128);
+      // verify
+      assertUnit(v.blocks.size() == 1);
+      if (v.blocks.size() == 1)
+      {
+         assertUnit(v.blocks[0].base == 5000000);
+         assertUnit(v.blocks[0].width == 7);
+      }
+      assertUnit(v.words.size() == 14);          // 128 * 7 bits
+   }  // teardown
+
+   // delta: gaps of 3 need 2 bits however big the values are
+   void test_pack_deltaWidth()
+   {  // setup
+      custom::packed_vector v(custom::packed_vector::delta);
+      // exercise
+      for (uint64_t i = 0; i < 128; i++)
+         v.push_back(900000000 + i * 3);
+      // verify
+      if (v.blocks.size() == 1)
+      {
+         assertUnit(v.blocks[0].base == 900000000);
+         assertUnit(v.blocks[0].width == 2);
+      }
+      assertUnit(v.words.size() == 4);
+   }  // teardown
+
+   // a block of one repeated value is all base, no words
+   void test_pack_allEqualTakesNoWords()
+   {  // setup
+      custom::packed_vector v;
+      // exercise
+      for (int i = 0; i < 128; i++)
+         v.push_back(42);
+      // verify
+      assertUnit(v.blocks.size() == 1);
+      assertUnit(v.words.size() == 0);
+      assertUnit(v[127] == 42);
+   }  // teardown
+
+   // values that need all 64 bits still round-trip
+   void test_pack_fullWidth()
+   {  // setup
+      custom::packed_vector v;
+      // exercise
+      for (uint64_t i = 0; i < 128; i++)
+         v.push_back(i % 2 ? ~uint64_t(0) - i : i);
+      // verify
+      if (v.blocks.size() == 1)
+         assertUnit(v.blocks[0].width == 64);
+      assertUnit(v[0] == 0);
+      assertUnit(v[1] == ~uint64_t(0) - 1);
+      assertUnit(v[126] == 126);
+      assertUnit(v[127] == ~uint64_t(0) - 127);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // every value of an unsorted frame vector comes back
+   void test_subscript_frame()
+   {  // setup
+      custom::packed_vector v;
+      for (uint64_t i = 0; i < 1000; i++)
+         v.push_back((i * 2654435761u) % 1048576);
+      bool same = true;
+      // exercise
+      for (uint64_t i = 0; i < 1000; i++)
+         same = same && v[i] == (i * 2654435761u) % 1048576;
+      // verify
+      assertUnit(same);
+   }  // teardown
+
+   // every value of a sorted delta vector comes back
+   void test_subscript_delta()
+   {  // setup
+      custom::packed_vector v(custom::packed_vector::delta);
+      uint64_t id = 0;
+      for (uint64_t i = 0; i < 1000; i++)
+         v.push_back(id += i % 17);
+      bool same = true;
+      // exercise
+      id = 0;
+      for (uint64_t i = 0; i < 1000; i++)
+         same = same && v[i] == (id += i % 17);
+      // verify
+      assertUnit(same);
+   }  // teardown
+
+   // decode 200 values starting mid-block and ending in the tail
+   void test_decode_straddlesBlocks()
+   {  // setup
+      custom::packed_vector v(custom::packed_vector::delta);
+      for (uint64_t i = 0; i < 300; i++)
+         v.push_back(i * 10);
+      uint64_t out[200];
+      // exercise
+      v.decode(100, 200, out);
+      // verify
+      assertUnit(out[0] == 1000);
+      assertUnit(out[28] == 1280);               // first of block 1
+      assertUnit(out[156] == 2560);              // first of the tail
+      assertUnit(out[199] == 2990);
+   }  // teardown
+
+   // delta encoding refuses a value smaller than the last
+   void test_pushback_deltaDecreasingThrows()
+   {  // setup
+      custom::packed_vector v(custom::packed_vector::delta);
+      v.push_back(49);
+      bool threw = false;
+      // exercise
+      try
+      {
+         v.push_back(26);
+      }
+      catch (const std::invalid_argument &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(v.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk packed blocks and the tail
+   void test_iterator_sum()
+   {  // setup
+      custom::packed_vector v(custom::packed_vector::delta);
+      for (uint64_t i = 0; i <= 1000; i++)
+         v.push_back(i);
+      uint64_t sum = 0;
+      // exercise
+      for (uint64_t value : v)
+         sum += value;
+      // verify
+      assertUnit(sum == 500500);
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // 100,000 sorted 30-bit IDs with small gaps shrink well over 3x
+   void test_memory_sortedIds()
+   {  // setup
+      custom::packed_vector vFrame;
+      custom::packed_vector vDelta(custom::packed_vector::delta);
+      uint64_t id = 500000000;
+      // exercise
+      for (uint64_t i = 0; i < 100000; i++)
+      {
+         id += 1 + (i * 7) % 13;
+         vFrame.push_back(id);
+         vDelta.push_back(id);
+      }
+      // verify
+      assertUnit(vFrame.memory_usage() * 3 < 100000 * sizeof(uint64_t));
+      assertUnit(vDelta.memory_usage() * 6 < 100000 * sizeof(uint64_t));
+      assertUnit(vFrame[99999] == id);
+      assertUnit(vDelta[99999] == id);
+   }  // teardown
+};
+
+#endif // DEBUG
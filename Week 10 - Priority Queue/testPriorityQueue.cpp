@@ -18,6 +18,17 @@
 #include "testPriorityQueue.h"  // for the priority queue unit tests
 #include "testSpy.h"            // for the spy unit tests
 #include "testVector.h"         // for the vector unit tests
+#include "testSmallVector.h"    // for the small vector unit tests
+#include "testMmapAllocator.h"  // for the mmap allocator unit tests
+#include "testMappedVector.h"   // for the mapped vector unit tests
+#include "testVectorSimd.h"     // for the vector search and reduction tests
+#include "testSoaVector.h"      // for the structure-of-arrays unit tests
+#include "testStableVector.h"   // for the stable vector unit tests
+#include "testConcurrentVector.h" // for the concurrent vector unit tests
+#include "testCowVector.h"        // for the cow vector unit tests
+#include "testBitVector.h"        // for the bit vector unit tests
+#include "testPackedVector.h"     // for the packed vector unit tests
+#include "testVectorSort.h"       // for the sort unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +41,17 @@ int main()
    // unit tests
    TestSpy().run();
    TestVector().run();
+   TestSmallVector().run();
+   TestMmapAllocator().run();
+   TestMappedVector().run();
+   TestVectorSimd().run();
+   TestSoaVector().run();
+   TestStableVector().run();
+   TestConcurrentVector().run();
+   TestCowVector().run();
+   TestBitVector().run();
+   TestPackedVector().run();
+   TestVectorSort().run();
    TestPQueue().run();
 #endif // DEBUG
    
@@ -12,13 +12,33 @@
 #ifdef DEBUG
 
 #include "priority_queue.h"
+#include "cow_vector.h"
 #include "unitTest.h"
 #include "spy.h"
 
 #include <cassert>
+#include <iterator>
 #include <memory>
+#include <sstream>
 
 
+/*************************************************************
+ * ARENA
+ * A minimal allocator that hands out slots from a caller's
+ * slab and never frees, so a test can see where memory went
+ *************************************************************/
+struct Arena
+{
+   typedef int value_type;
+   int * next;
+   int used;
+   Arena(int * slab) : next(slab), used(0) {}
+   int * allocate(size_t n)        { used += (int)n; int * p = next; next += n; return p; }
+   void deallocate(int *, size_t)  { }
+   bool operator == (const Arena & rhs) const { return next == rhs.next; }
+   bool operator != (const Arena & rhs) const { return next != rhs.next; }
+};
+
 class TestPQueue : public UnitTest
 {
 
@@ -29,13 +49,16 @@ public:
 
       // Construct
       test_construct_default();
+      test_construct_allocator();
       test_constructCopy_empty();
       test_constructCopy_standard();
+      test_constructCopy_cowShares();
       test_constructMove_empty();
       test_constructMove_standard();
       test_constructRange_empty();
       test_constructRange_one();
       test_constructRange_staandard();
+      test_constructRange_inputIterator();
       test_constructMoveInit_empty();
       test_constructMoveInit_one();
       test_constructMoveInit_standard();
@@ -67,6 +90,7 @@ public:
       test_pop_one();
       test_pop_two();
       test_pop_standard();
+      test_pop_bool();
 
       // Status
       test_size_empty();
@@ -95,6 +119,22 @@ public:
       assertUnit(pq.container.empty());
    }  // teardown
 
+   // the allocator handed to the queue is the one the heap grows with
+   void test_construct_allocator()
+   {  // setup
+      int slab[16];
+      // exercise
+      custom::priority_queue <int, custom::vector <int, Arena>> pq(Arena{slab});
+      pq.push(3);
+      pq.push(9);
+      pq.push(5);
+      // verify
+      assertUnit(pq.size() == 3);
+      assertUnit(pq.top() == 9);
+      assertUnit(pq.container.alloc.used == 1 + 2 + 4);  // grew 1, 2, 4
+      assertUnit(pq.container.data >= slab && pq.container.data < slab + 16);
+   }  // teardown
+
 
    
    /***************************************
@@ -145,6 +185,30 @@ public:
       teardownStandardFixture(pqSrc);
       teardownStandardFixture(pqDest);
    }
+
+   // copying a queue kept in a cow_vector shares the heap: no Spy is copied
+   void test_constructCopy_cowShares()
+   {  // setup
+      custom::priority_queue<Spy, custom::cow_vector<Spy>> pqSrc;
+      pqSrc.push(Spy(10));
+      pqSrc.push(Spy(8));
+      pqSrc.push(Spy(9));
+      Spy::reset();
+      // exercise
+      custom::priority_queue<Spy, custom::cow_vector<Spy>> pqDest(pqSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(pqDest.container.use_count() == 2);
+      assertUnit(pqDest.size() == 3);
+      assertUnit(pqDest.top() == Spy(10));
+      // exercise
+      pqDest.pop();
+      // verify
+      assertUnit(pqDest.size() == 2);
+      assertUnit(pqSrc.size() == 3);
+      assertUnit(pqSrc.top() == Spy(10));
+   }  // teardown
    
    /***************************************
     * MOVE CONSTRUCTOR
@@ -244,6 +308,28 @@ public:
       teardownStandardFixture(pq);
    }
    
+   // priority_queue(istream_iterator("3 9 4"), istream_iterator())
+   void test_constructRange_inputIterator()
+   {  // setup
+      std::istringstream in("3 9 4");
+      std::istream_iterator<int> first(in);
+      std::istream_iterator<int> last;
+      // exercise: the range can only be read once
+      custom::priority_queue<int> pq(first, last);
+      // verify
+      //                9
+      //          3            4
+      assertUnit(pq.container.size() == 3);
+      if (pq.container.size() == 3)
+      {
+         assertUnit(pq.container[0] == int(9));
+         assertUnit(pq.container[1] == int(3));
+         assertUnit(pq.container[2] == int(4));
+      }
+      // teardown
+      teardownStandardFixture(pq);
+   }
+
    /***************************************
     * MOVE CONTAINER INITIALIZE CONSTRUCTOR
     ***************************************/
@@ -763,6 +849,22 @@ public:
       teardownStandardFixture(pq);
    }
 
+   // a queue of flags: true comes out first, then the falses
+   void test_pop_bool()
+   {  // setup
+      custom::priority_queue <bool> pq;
+      pq.push(false);
+      pq.push(true);
+      pq.push(false);
+      // exercise
+      bool first = pq.top();
+      pq.pop();
+      // verify
+      assertUnit(first == true);
+      assertUnit(pq.size() == 2);
+      assertUnit(pq.top() == false);
+   }  // teardown
+
    
 
    /***************************************
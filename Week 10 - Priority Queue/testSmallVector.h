@@ -0,0 +1,415 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for small_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+
+class TestSmallVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeThree();
+      test_construct_sizeSix();
+      test_constructCopy_inline();
+      test_constructCopy_heap();
+      test_constructCopy_throwFreesHeap();
+      test_constructMove_inline();
+      test_constructMove_heap();
+
+      // Assign
+      test_assign_heapToInline();
+      test_assignMove_heap();
+      test_swap_inlineHeap();
+
+      // Iterator
+      test_iterator_sum();
+      test_iterator_const();
+      test_iterator_reverse();
+      test_iterator_bool();
+
+      // Insert
+      test_pushback_fits();
+      test_pushback_spill();
+      test_emplace_middle();
+
+      // Remove
+      test_popback_inline();
+      test_shrink_backInline();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no allocations
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::small_vector<int, 4> v;
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   // three elements fit in the four inline slots
+   void test_construct_sizeThree()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(3);
+      // verify
+      assertUnit(Spy::numDefault() == 3);        // default [  ,  ,  ]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+   }  // teardown
+
+   // six elements do not fit: straight to a heap buffer of six
+   void test_construct_sizeSix()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(6, Spy(99));
+      // verify
+      assertUnit(Spy::numCopy() == 6);           // copy [99,99,99,99,99,99]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+   }  // teardown
+
+   // copy of an inline vector stays inline
+   void test_constructCopy_inline()
+   {  // setup
+      custom::small_vector<int, 4> vSrc{26, 49};
+      // exercise
+      custom::small_vector<int, 4> vDest(vSrc);
+      // verify
+      assertUnit(vDest.isInline());
+      assertUnit(vDest.numElements == 2);
+      assertUnit(vDest[0] == 26);
+      assertUnit(vDest[1] == 49);
+      assertUnit(vSrc.numElements == 2);
+   }  // teardown
+
+   // copy of a spilled vector gets its own heap buffer
+   void test_constructCopy_heap()
+   {  // setup
+      custom::small_vector<int, 2> vSrc{26, 49, 67, 89};
+      // exercise
+      custom::small_vector<int, 2> vDest(vSrc);
+      // verify
+      assertUnit(!vDest.isInline());
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(vDest.numCapacity == 4);
+      assertUnit(vDest.numElements == 4);
+      assertUnit(vDest[3] == 89);
+   }  // teardown
+
+   // a copy that throws part way leaves nothing behind
+   void test_constructCopy_throwFreesHeap()
+   {  // setup
+      struct Fussy
+      {
+         int value;
+         int * pLive;
+         Fussy(int v, int * p) : value(v), pLive(p) { (*pLive)++; }
+         Fussy(const Fussy & rhs) : value(rhs.value), pLive(rhs.pLive)
+         {
+            if (value < 0)
+               throw std::invalid_argument("negative");
+            (*pLive)++;
+         }
+         ~Fussy() { (*pLive)--; }
+      };
+      int live = 0;
+      custom::small_vector<Fussy, 2> vSrc;
+      vSrc.emplace_back(26, &live);
+      vSrc.emplace_back(49, &live);
+      vSrc.emplace_back(67, &live);
+      vSrc.emplace_back(-1, &live);
+      bool threw = false;
+      // exercise
+      try
+      {
+         custom::small_vector<Fussy, 2> vDest(vSrc);
+      }
+      catch (const std::invalid_argument &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(live == 4);                     // only vSrc's [26,49,67,-1]
+      assertUnit(vSrc.numElements == 4);
+   }  // teardown
+
+   // moving inline elements moves each one
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 2);       // move [26,49]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 2);     // destroy empty [  ,  ]
+      assertUnit(vDest.isInline());
+      assertUnit(vDest.numElements == 2);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+      if (vDest.numElements == 2)
+         assertUnit(vDest[1] == Spy(49));
+   }  // teardown
+
+   // moving a heap buffer just steals the pointer
+   void test_constructMove_heap()
+   {  // setup
+      custom::small_vector<Spy, 1> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      Spy * pSrc = vSrc.data;
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 1> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vDest.data == pSrc);
+      assertUnit(vDest.numElements == 2);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assigning a big vector onto a small one spills to the heap
+   void test_assign_heapToInline()
+   {  // setup
+      custom::small_vector<int, 2> vSrc{26, 49, 67, 89};
+      custom::small_vector<int, 2> vDest{99};
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(!vDest.isInline());
+      assertUnit(vDest.numElements == 4);
+      assertUnit(vDest[0] == 26);
+      assertUnit(vDest[3] == 89);
+   }  // teardown
+
+   // move-assign a heap vector: pointer is stolen, old contents freed
+   void test_assignMove_heap()
+   {  // setup
+      custom::small_vector<int, 2> vSrc{26, 49, 67, 89};
+      custom::small_vector<int, 2> vDest{99, 99, 99};
+      int * pSrc = vSrc.data;
+      // exercise
+      vDest = std::move(vSrc);
+      // verify
+      assertUnit(vDest.data == pSrc);
+      assertUnit(vDest.numElements == 4);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   // swap one inline and one spilled vector
+   void test_swap_inlineHeap()
+   {  // setup
+      custom::small_vector<int, 2> vLeft{26};
+      custom::small_vector<int, 2> vRight{67, 89, 99};
+      // exercise
+      vLeft.swap(vRight);
+      // verify
+      assertUnit(!vLeft.isInline());
+      assertUnit(vLeft.numElements == 3);
+      assertUnit(vLeft[0] == 67);
+      assertUnit(vLeft[2] == 99);
+      assertUnit(vRight.isInline());
+      assertUnit(vRight.numElements == 1);
+      assertUnit(vRight[0] == 26);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk the elements with the shared vector iterator
+   void test_iterator_sum()
+   {  // setup
+      custom::small_vector<int, 4> v{26, 49, 67, 89};
+      int sum = 0;
+      // exercise
+      for (custom::small_vector<int, 4>::iterator it = v.begin(); it != v.end(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+   }  // teardown
+
+   // a const vector hands out const_iterators
+   void test_iterator_const()
+   {  // setup
+      const custom::small_vector<int, 4> v{26, 49, 67, 89};
+      int sum = 0;
+      // exercise
+      for (custom::small_vector<int, 4>::const_iterator it = v.cbegin(); it != v.cend(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertUnit(v.end() - v.begin() == 4);
+   }  // teardown
+
+   // walk a spilled vector back to front
+   void test_iterator_reverse()
+   {  // setup
+      custom::small_vector<int, 2> v{26, 49, 67};
+      int values[3] = {};
+      int i = 0;
+      // exercise
+      for (custom::small_vector<int, 2>::reverse_iterator it = v.rbegin(); it != v.rend(); ++it)
+         values[i++] = *it;
+      // verify
+      assertUnit(i == 3);
+      assertUnit(values[0] == 67);
+      assertUnit(values[1] == 49);
+      assertUnit(values[2] == 26);
+      const custom::small_vector<int, 2> & cv = v;
+      assertUnit(*cv.crbegin() == 67);
+      assertUnit(*(cv.crend() - 1) == 26);
+   }  // teardown
+
+   // flags spill to the heap and walk like anything else
+   void test_iterator_bool()
+   {  // setup
+      custom::small_vector<bool, 2> v;
+      v.push_back(true);
+      v.push_back(false);
+      v.push_back(true);
+      int numTrue = 0;
+      // exercise
+      for (custom::small_vector<bool, 2>::iterator it = v.begin(); it != v.end(); ++it)
+         numTrue += *it ? 1 : 0;
+      v.back() = false;
+      // verify
+      assertUnit(!v.isInline());
+      assertUnit(numTrue == 2);
+      assertUnit(v[2] == false);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // pushing up to N never touches the heap
+   void test_pushback_fits()
+   {  // setup
+      custom::small_vector<int, 4> v;
+      // exercise
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      v.push_back(89);
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(v[3] == 89);
+   }  // teardown
+
+   // the N+1st push spills to a heap buffer of 2N
+   void test_pushback_spill()
+   {  // setup
+      custom::small_vector<Spy, 2> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(Spy::numCopy() == 1);           // copy [26]
+      assertUnit(Spy::numCopyMove() == 3);       // move the copy, [26,49]
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+         assertUnit(v[2] == Spy(26));
+   }  // teardown
+
+   // insert into the middle, inline
+   void test_emplace_middle()
+   {  // setup
+      custom::small_vector<int, 4> v{26, 67, 89};
+      // exercise
+      custom::small_vector<int, 4>::iterator it = v.emplace(++v.begin(), 49);
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(*it == 49);
+      assertUnit(v.numElements == 4);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 67);
+      assertUnit(v[3] == 89);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back destroys the last inline element
+   void test_popback_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);     // destroy [49]
+      assertUnit(v.numElements == 1);
+   }  // teardown
+
+   // shrinking a spilled vector that fits again moves back inline
+   void test_shrink_backInline()
+   {  // setup
+      custom::small_vector<int, 2> v{26, 49, 67};
+      v.pop_back();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.numElements == 2);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+   }  // teardown
+};
+
+#endif // DEBUG
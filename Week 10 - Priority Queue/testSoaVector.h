@@ -0,0 +1,361 @@
+/***********************************************************************
+ * Header:
+ *    TEST SOA VECTOR
+ * Summary:
+ *    Unit tests for soa_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "soa_vector.h"
+#include "vector_simd.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <string>
+#include <tuple>
+
+class TestSoaVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_pushback_tuple();
+      test_pushback_moveTuple();
+      test_emplaceback_fields();
+      test_reserve_allColumns();
+      test_pushback_throwKeepsColumnsEven();
+
+      // Access
+      test_subscript_rowWrite();
+      test_get_field();
+      test_column_contiguous();
+      test_column_sum();
+      test_column_bool();
+
+      // Iterator
+      test_iterator_walkRows();
+      test_iterator_arithmetic();
+      test_iterator_randomAccess();
+      test_iterator_const();
+
+      // Remove
+      test_popback();
+      test_clear();
+
+      report("SoaVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, every column empty
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::soa_vector<int, double> v;
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(std::get<0>(v.columns).size() == 0);
+      assertUnit(std::get<1>(v.columns).size() == 0);
+      assertUnit(v.column<1>().data() == nullptr);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // one row goes into each column
+   void test_pushback_tuple()
+   {  // setup
+      custom::soa_vector<int, double, char> v;
+      // exercise
+      v.push_back(std::make_tuple(26, 2.6, 'a'));
+      v.push_back(std::make_tuple(49, 4.9, 'b'));
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(std::get<0>(v.columns)[1] == 49);
+      assertUnit(std::get<1>(v.columns)[1] == 4.9);
+      assertUnit(std::get<2>(v.columns)[0] == 'a');
+   }  // teardown
+
+   // pushing a temporary tuple moves each field
+   void test_pushback_moveTuple()
+   {  // setup
+      custom::soa_vector<int, Spy> v;
+      std::tuple<int, Spy> row(26, Spy(99));
+      Spy::reset();
+      // exercise
+      v.push_back(std::move(row));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 1);       // move [99]
+      assertUnit(v.size() == 1);
+      assertUnit(std::get<1>(v.columns)[0] == Spy(99));
+   }  // teardown
+
+   // each argument builds its own field in place
+   void test_emplaceback_fields()
+   {  // setup
+      custom::soa_vector<int, std::string> v;
+      // exercise
+      v.emplace_back(26, "twenty-six");
+      v.emplace_back(49, std::string(3, 'x'));
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(std::get<1>(v.columns)[0] == "twenty-six");
+      assertUnit(std::get<1>(v.columns)[1] == "xxx");
+   }  // teardown
+
+   // reserve grows every column once
+   void test_reserve_allColumns()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(v.capacity() == 10);
+      assertUnit(std::get<0>(v.columns).capacity() == 10);
+      assertUnit(std::get<1>(v.columns).capacity() == 10);
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   // if a later field fails, the earlier ones are taken back
+   void test_pushback_throwKeepsColumnsEven()
+   {  // setup
+      custom::soa_vector<int, Thrower> v;
+      v.emplace_back(26, false);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         v.emplace_back(49, true);
+      }
+      catch (int)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(v.size() == 1);
+      assertUnit(std::get<0>(v.columns).size() == 1);
+      assertUnit(std::get<1>(v.columns).size() == 1);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a row is a tuple of references: write through it
+   void test_subscript_rowWrite()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.push_back(std::make_tuple(26, 2.6));
+      v.push_back(std::make_tuple(49, 4.9));
+      // exercise
+      std::get<1>(v[1]) = 9.9;
+      // verify
+      assertUnit(std::get<1>(v.columns)[1] == 9.9);
+      assertUnit(std::get<0>(v[1]) == 49);
+   }  // teardown
+
+   // a single field of a single row
+   void test_get_field()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.push_back(std::make_tuple(26, 2.6));
+      const custom::soa_vector<int, double> & cv = v;
+      // exercise
+      v.get<0>(0) = 67;
+      // verify
+      assertUnit(cv.get<0>(0) == 67);
+      assertUnit(cv.get<1>(0) == 2.6);
+   }  // teardown
+
+   // a column is the vector's own buffer
+   void test_column_contiguous()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.push_back(std::make_tuple(26, 2.6));
+      v.push_back(std::make_tuple(49, 4.9));
+      v.push_back(std::make_tuple(67, 6.7));
+      // exercise
+      custom::span<int> ids = v.column<0>();
+      // verify
+      assertUnit(ids.size() == 3);
+      assertUnit(ids.data() == &std::get<0>(v.columns)[0]);
+      assertUnit(ids[2] == 67);
+      assertUnit(ids.end() - ids.begin() == 3);
+   }  // teardown
+
+   // a column scan runs through the vectorized kernels
+   void test_column_sum()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      for (int i = 0; i <= 100; i++)
+         v.push_back(std::make_tuple(i, 0.5));
+      const custom::soa_vector<int, double> & cv = v;
+      // exercise
+      custom::span<const int> ids = cv.column<0>();
+      int s = custom::simd::sum(ids.data(), ids.size());
+      // verify
+      assertUnit(s == 5050);
+   }  // teardown
+
+   // a column of flags is a plain array of bools
+   void test_column_bool()
+   {  // setup
+      custom::soa_vector<int, bool> v;
+      v.push_back(std::make_tuple(26, true));
+      v.push_back(std::make_tuple(49, false));
+      v.push_back(std::make_tuple(67, true));
+      // exercise
+      custom::span<bool> flags = v.column<1>();
+      v.get<1>(1) = true;
+      std::get<1>(v[2]) = false;
+      // verify
+      assertUnit(flags.size() == 3);
+      assertUnit(flags[0] == true);
+      assertUnit(flags[1] == true);
+      assertUnit(flags[2] == false);
+      assertUnit(&flags[1] == &v.get<1>(1));
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // visit every row in order
+   void test_iterator_walkRows()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.push_back(std::make_tuple(26, 'a'));
+      v.push_back(std::make_tuple(49, 'b'));
+      v.push_back(std::make_tuple(67, 'c'));
+      int sum = 0;
+      // exercise
+      for (custom::soa_vector<int, char>::iterator it = v.begin(); it != v.end(); ++it)
+      {
+         sum += std::get<0>(*it);
+         std::get<1>(*it) = 'z';
+      }
+      // verify
+      assertUnit(sum == 26 + 49 + 67);
+      assertUnit(std::get<1>(v.columns)[0] == 'z');
+      assertUnit(std::get<1>(v.columns)[2] == 'z');
+   }  // teardown
+
+   // jump around the rows
+   void test_iterator_arithmetic()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.push_back(std::make_tuple(26, 'a'));
+      v.push_back(std::make_tuple(49, 'b'));
+      v.push_back(std::make_tuple(67, 'c'));
+      // exercise
+      custom::soa_vector<int, char>::iterator it = v.begin() + 2;
+      // verify
+      assertUnit(std::get<0>(*it) == 67);
+      assertUnit(std::get<1>(it[-1]) == 'b');
+      assertUnit(v.end() - v.begin() == 3);
+      assertUnit(v.begin() < it);
+   }  // teardown
+
+   // the rest of what a random-access iterator promises
+   void test_iterator_randomAccess()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.push_back(std::make_tuple(26, 'a'));
+      v.push_back(std::make_tuple(49, 'b'));
+      v.push_back(std::make_tuple(67, 'c'));
+      v.push_back(std::make_tuple(89, 'd'));
+      custom::soa_vector<int, char>::iterator it = v.end();
+      // exercise
+      it -= 3;
+      // verify
+      assertUnit(std::get<0>(*it) == 49);
+      assertUnit(std::get<0>(*(2 + it)) == 89);
+      assertUnit(std::get<0>(*(it - 1)) == 26);
+      assertUnit(std::get<1>(it[1]) == 'c');
+      assertUnit(it > v.begin());
+      assertUnit(it >= v.begin() + 1);
+      assertUnit(it <= v.begin() + 1);
+      assertUnit(!(it <= v.begin()));
+      assertUnit(std::distance(v.begin(), v.end()) == 4);
+   }  // teardown
+
+   // a const table walks with const_iterator and cannot be written
+   void test_iterator_const()
+   {  // setup
+      custom::soa_vector<int, char> v;
+      v.push_back(std::make_tuple(26, 'a'));
+      v.push_back(std::make_tuple(49, 'b'));
+      const custom::soa_vector<int, char> & cv = v;
+      int sum = 0;
+      // exercise
+      for (custom::soa_vector<int, char>::const_iterator it = cv.cbegin(); it != cv.cend(); ++it)
+         sum += std::get<0>(*it);
+      // verify
+      assertUnit(sum == 26 + 49);
+      custom::soa_vector<int, char>::const_iterator cit = v.begin();
+      assertUnit(cit == v.begin());
+      assertUnit(v.end() - cit == 2);
+      assertUnit((std::is_same<decltype(std::get<0>(*cit)), const int &>::value));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back shortens every column
+   void test_popback()
+   {  // setup
+      custom::soa_vector<int, Spy> v;
+      v.push_back(std::make_tuple(26, Spy(26)));
+      v.push_back(std::make_tuple(49, Spy(49)));
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);     // destroy [49]
+      assertUnit(v.size() == 1);
+      assertUnit(std::get<0>(v.columns).size() == 1);
+      assertUnit(std::get<1>(v.columns).size() == 1);
+   }  // teardown
+
+   // clear empties every column
+   void test_clear()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.push_back(std::make_tuple(26, 2.6));
+      v.push_back(std::make_tuple(49, 4.9));
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(v.empty());
+      assertUnit(std::get<0>(v.columns).size() == 0);
+      assertUnit(std::get<1>(v.columns).size() == 0);
+   }  // teardown
+
+private:
+   // a field whose constructor can be told to fail
+   struct Thrower
+   {
+      Thrower(bool fail) { if (fail) throw 99; }
+   };
+};
+
+#endif // DEBUG
@@ -0,0 +1,342 @@
+/***********************************************************************
+ * Header:
+ *    TEST STABLE VECTOR
+ * Summary:
+ *    Unit tests for stable_vector
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "stable_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <algorithm>
+
+class TestStableVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Segment
+      test_segment_firstBlock();
+      test_segment_blockBoundaries();
+
+      // Construct
+      test_construct_default();
+      test_construct_fill();
+      test_constructCopy();
+      test_constructMove_keepsAddresses();
+
+      // Assign
+      test_assign_copy();
+      test_swap();
+      test_swap_unusedBlocksNull();
+
+      // Insert
+      test_pushback_addsBlocks();
+      test_pushback_pointersStayValid();
+      test_spy_pushbackNoMoves();
+      test_reserve();
+
+      // Iterator
+      test_iterator_sum();
+      test_iterator_sort();
+
+      // Remove
+      test_popback();
+      test_clear_keepsBlocks();
+      test_shrink_releasesBlocks();
+
+      report("StableVector");
+   }
+
+   /***************************************
+    * SEGMENT
+    ***************************************/
+
+   // indices 0..7 are the first block of eight
+   void test_segment_firstBlock()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::segment::block(0) == 0);
+      assertUnit(custom::segment::offset(0) == 0);
+      assertUnit(custom::segment::block(7) == 0);
+      assertUnit(custom::segment::offset(7) == 7);
+   }  // teardown
+
+   // blocks of 8, 16, 32 start at 0, 8, 24
+   void test_segment_blockBoundaries()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::segment::block(8) == 1);
+      assertUnit(custom::segment::offset(8) == 0);
+      assertUnit(custom::segment::block(23) == 1);
+      assertUnit(custom::segment::offset(23) == 15);
+      assertUnit(custom::segment::block(24) == 2);
+      assertUnit(custom::segment::offset(24) == 0);
+      assertUnit(custom::segment::blockStart(3) == 56);
+      assertUnit(custom::segment::blockSize(3) == 64);
+      assertUnit(custom::segment::block(1000000) == 16);
+   }  // teardown
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no blocks
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::stable_vector<int> v;
+      // verify
+      assertUnit(v.numBlocks == 0);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.capacity() == 0);
+   }  // teardown
+
+   // ten copies need two blocks: 8 + 16
+   void test_construct_fill()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::stable_vector<Spy> v(10, Spy(99));
+      // verify
+      assertUnit(Spy::numCopy() == 10);          // copy [99,99,...]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.numBlocks == 2);
+      assertUnit(v.capacity() == 24);
+      assertUnit(v.size() == 10);
+      if (v.size() == 10)
+         assertUnit(v[9] == Spy(99));
+   }  // teardown
+
+   // a copy has blocks of its own
+   void test_constructCopy()
+   {  // setup
+      custom::stable_vector<int> vSrc{26, 49, 67, 89, 11, 22, 33, 44, 55};
+      // exercise
+      custom::stable_vector<int> vDest(vSrc);
+      // verify
+      assertUnit(vDest.size() == 9);
+      assertUnit(vDest.blocks[0] != vSrc.blocks[0]);
+      assertUnit(vDest[0] == 26);
+      assertUnit(vDest[8] == 55);
+      assertUnit(vSrc.size() == 9);
+   }  // teardown
+
+   // moving takes the blocks, so element addresses do not change
+   void test_constructMove_keepsAddresses()
+   {  // setup
+      custom::stable_vector<int> vSrc{26, 49, 67};
+      int * p = &vSrc[1];
+      // exercise
+      custom::stable_vector<int> vDest(std::move(vSrc));
+      // verify
+      assertUnit(&vDest[1] == p);
+      assertUnit(vDest.size() == 3);
+      assertUnit(vSrc.size() == 0);
+      assertUnit(vSrc.numBlocks == 0);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assign a bigger vector onto a smaller one
+   void test_assign_copy()
+   {  // setup
+      custom::stable_vector<int> vSrc(20, 7);
+      custom::stable_vector<int> vDest{26};
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(vDest.size() == 20);
+      assertUnit(vDest[0] == 7);
+      assertUnit(vDest[19] == 7);
+   }  // teardown
+
+   // swap trades the block lists
+   void test_swap()
+   {  // setup
+      custom::stable_vector<int> vLeft{26};
+      custom::stable_vector<int> vRight(30, 7);
+      int * pRight = &vRight[29];
+      // exercise
+      vLeft.swap(vRight);
+      // verify
+      assertUnit(vLeft.size() == 30);
+      assertUnit(&vLeft[29] == pRight);
+      assertUnit(vRight.size() == 1);
+      assertUnit(vRight[0] == 26);
+   }  // teardown
+
+   // the block entries past numBlocks stay null on both sides of a swap
+   void test_swap_unusedBlocksNull()
+   {  // setup
+      custom::stable_vector<int> vLeft{26};
+      custom::stable_vector<int> vRight(30, 7);
+      // exercise
+      vLeft.swap(vRight);
+      // verify
+      assertUnit(vLeft.numBlocks == 3);
+      assertUnit(vRight.numBlocks == 1);
+      for (size_t k = vLeft.numBlocks; k < custom::segment::maxBlocks; k++)
+         assertUnit(vLeft.blocks[k] == nullptr);
+      for (size_t k = vRight.numBlocks; k < custom::segment::maxBlocks; k++)
+         assertUnit(vRight.blocks[k] == nullptr);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the ninth push adds the second block
+   void test_pushback_addsBlocks()
+   {  // setup
+      custom::stable_vector<int> v;
+      for (int i = 0; i < 8; i++)
+         v.push_back(i);
+      assertUnit(v.numBlocks == 1);
+      // exercise
+      v.push_back(8);
+      // verify
+      assertUnit(v.numBlocks == 2);
+      assertUnit(v.capacity() == 24);
+      assertUnit(v[8] == 8);
+   }  // teardown
+
+   // a pointer taken early survives a million appends
+   void test_pushback_pointersStayValid()
+   {  // setup
+      custom::stable_vector<int> v;
+      v.push_back(26);
+      int * pFirst = &v[0];
+      // exercise
+      for (int i = 1; i < 1000000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(&v[0] == pFirst);
+      assertUnit(*pFirst == 26);
+      assertUnit(v.size() == 1000000);
+      assertUnit(v[999999] == 999999);
+   }  // teardown
+
+   // growing never copies or moves an existing element
+   void test_spy_pushbackNoMoves()
+   {  // setup
+      custom::stable_vector<Spy> v;
+      for (int i = 0; i < 8; i++)
+         v.push_back(Spy(i));
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);           // copy [99]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.size() == 9);
+   }  // teardown
+
+   // reserve adds whole blocks
+   void test_reserve()
+   {  // setup
+      custom::stable_vector<int> v;
+      // exercise
+      v.reserve(25);
+      // verify
+      assertUnit(v.numBlocks == 3);
+      assertUnit(v.capacity() == 56);
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk across block boundaries
+   void test_iterator_sum()
+   {  // setup
+      custom::stable_vector<int> v;
+      for (int i = 0; i <= 100; i++)
+         v.push_back(i);
+      int sum = 0;
+      // exercise
+      for (custom::stable_vector<int>::iterator it = v.begin(); it != v.end(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 5050);
+      assertUnit(v.end() - v.begin() == 101);
+   }  // teardown
+
+   // the iterator is random access, so std::sort works
+   void test_iterator_sort()
+   {  // setup
+      custom::stable_vector<int> v;
+      for (int i = 40; i > 0; i--)
+         v.push_back(i);
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      assertUnit(v[0] == 1);
+      assertUnit(v[8] == 9);
+      assertUnit(v[39] == 40);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop_back destroys the last element
+   void test_popback()
+   {  // setup
+      custom::stable_vector<Spy> v;
+      for (int i = 0; i < 9; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);     // destroy [8]
+      assertUnit(v.size() == 8);
+      if (v.size() == 8)
+         assertUnit(v.back() == Spy(7));
+   }  // teardown
+
+   // clear keeps the blocks for reuse
+   void test_clear_keepsBlocks()
+   {  // setup
+      custom::stable_vector<int> v(20, 7);
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.numBlocks == 2);
+   }  // teardown
+
+   // shrink_to_fit frees the blocks past the last element
+   void test_shrink_releasesBlocks()
+   {  // setup
+      custom::stable_vector<int> v;
+      v.reserve(100);
+      v.push_back(26);
+      v.push_back(49);
+      int * p = &v[0];
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.numBlocks == 1);
+      assertUnit(&v[0] == p);
+      assertUnit(v[1] == 49);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,342 @@
+/***********************************************************************
+ * Header:
+ *    TEST VECTOR SIMD
+ * Summary:
+ *    Unit tests for the vector search and reduction kernels
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "vector_simd.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+
+class TestVectorSimd : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Find
+      test_find_empty();
+      test_find_int();
+      test_find_intTail();
+      test_find_missing();
+      test_find_float();
+      test_find_double();
+
+      // Count
+      test_count_int();
+      test_count_float();
+      test_count_double();
+
+      // Min and max
+      test_minElement_empty();
+      test_minElement_int();
+      test_maxElement_intTail();
+      test_minElement_firstOfTies();
+      test_maxElement_float();
+      test_minElement_double();
+
+      // Sum and dot
+      test_sum_empty();
+      test_sum_int();
+      test_sum_float();
+      test_sum_double();
+      test_dot_int();
+      test_dot_float();
+      test_dot_double();
+
+      // Scalar fallback
+      test_sum_long();
+
+      report("VectorSimd");
+   }
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // nothing to find in an empty vector
+   void test_find_empty()
+   {  // setup
+      custom::vector<int32_t> v;
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::find(v, 26);
+      // verify
+      assertUnit(it == v.end());
+   }  // teardown
+
+   // the first match in a full block of four
+   void test_find_int()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(100);
+      v[61] = -1;
+      v[70] = -1;
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::find(v, -1);
+      // verify
+      assertUnit(it - v.cbegin() == 61);
+   }  // teardown
+
+   // a match in the leftover elements past the last block
+   void test_find_intTail()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(7);
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::find(v, 6);
+      // verify
+      assertUnit(it - v.cbegin() == 6);
+   }  // teardown
+
+   // no match gives end()
+   void test_find_missing()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(100);
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::find(v, 100);
+      // verify
+      assertUnit(it == v.end());
+   }  // teardown
+
+   // floats
+   void test_find_float()
+   {  // setup
+      custom::vector<float> v = ramp<float>(33);
+      // exercise
+      custom::vector<float>::const_iterator it = custom::find(v, 17.0f);
+      // verify
+      assertUnit(it - v.cbegin() == 17);
+      assertUnit(custom::find(v, 0.5f) == v.end());
+   }  // teardown
+
+   // doubles
+   void test_find_double()
+   {  // setup
+      custom::vector<double> v = ramp<double>(33);
+      // exercise
+      custom::vector<double>::const_iterator it = custom::find(v, 32.0);
+      // verify
+      assertUnit(it - v.cbegin() == 32);
+      assertUnit(custom::find(v, -1.0) == v.end());
+   }  // teardown
+
+   /***************************************
+    * COUNT
+    ***************************************/
+
+   // every third element matches, plus some in the tail
+   void test_count_int()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(103);
+      for (size_t i = 0; i < v.size(); i += 3)
+         v[i] = -7;
+      // exercise
+      size_t num = custom::count(v, -7);
+      // verify
+      assertUnit(num == 35);
+   }  // teardown
+
+   // floats
+   void test_count_float()
+   {  // setup
+      custom::vector<float> v(21, 2.5f);
+      v[20] = 1.0f;
+      // exercise
+      size_t num = custom::count(v, 2.5f);
+      // verify
+      assertUnit(num == 20);
+   }  // teardown
+
+   // doubles
+   void test_count_double()
+   {  // setup
+      custom::vector<double> v(21, 2.5);
+      v[0] = 1.0;
+      // exercise
+      size_t num = custom::count(v, 2.5);
+      // verify
+      assertUnit(num == 20);
+   }  // teardown
+
+   /***************************************
+    * MIN AND MAX
+    ***************************************/
+
+   // no smallest element in an empty vector
+   void test_minElement_empty()
+   {  // setup
+      custom::vector<int32_t> v;
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::min_element(v);
+      // verify
+      assertUnit(it == v.end());
+   }  // teardown
+
+   // smallest int, including negatives
+   void test_minElement_int()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(64);
+      v[40] = -99;
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::min_element(v);
+      // verify
+      assertUnit(it - v.cbegin() == 40);
+      assertUnit(*it == -99);
+   }  // teardown
+
+   // largest int sits past the last block of four
+   void test_maxElement_intTail()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(10);
+      v[9] = 1000;
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::max_element(v);
+      // verify
+      assertUnit(it - v.cbegin() == 9);
+   }  // teardown
+
+   // ties go to the first one, like std::min_element
+   void test_minElement_firstOfTies()
+   {  // setup
+      custom::vector<int32_t> v(20, 5);
+      v[3] = 1;
+      v[13] = 1;
+      // exercise
+      custom::vector<int32_t>::const_iterator it = custom::min_element(v);
+      // verify
+      assertUnit(it - v.cbegin() == 3);
+   }  // teardown
+
+   // floats
+   void test_maxElement_float()
+   {  // setup
+      custom::vector<float> v = ramp<float>(17);
+      v[5] = 99.5f;
+      // exercise
+      custom::vector<float>::const_iterator it = custom::max_element(v);
+      // verify
+      assertUnit(it - v.cbegin() == 5);
+   }  // teardown
+
+   // doubles
+   void test_minElement_double()
+   {  // setup
+      custom::vector<double> v = ramp<double>(9);
+      v[8] = -0.5;
+      // exercise
+      custom::vector<double>::const_iterator it = custom::min_element(v);
+      // verify
+      assertUnit(it - v.cbegin() == 8);
+   }  // teardown
+
+   /***************************************
+    * SUM AND DOT
+    ***************************************/
+
+   // an empty vector sums to zero
+   void test_sum_empty()
+   {  // setup
+      custom::vector<double> v;
+      // exercise
+      double s = custom::sum(v);
+      // verify
+      assertUnit(s == 0.0);
+   }  // teardown
+
+   // 0 + 1 + ... + 100
+   void test_sum_int()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(101);
+      // exercise
+      int32_t s = custom::sum(v);
+      // verify
+      assertUnit(s == 5050);
+   }  // teardown
+
+   // small whole numbers add exactly in any order
+   void test_sum_float()
+   {  // setup
+      custom::vector<float> v = ramp<float>(101);
+      // exercise
+      float s = custom::sum(v);
+      // verify
+      assertUnit(s == 5050.0f);
+   }  // teardown
+
+   // doubles
+   void test_sum_double()
+   {  // setup
+      custom::vector<double> v = ramp<double>(101);
+      // exercise
+      double s = custom::sum(v);
+      // verify
+      assertUnit(s == 5050.0);
+   }  // teardown
+
+   // 0*0 + 1*1 + ... + 9*9
+   void test_dot_int()
+   {  // setup
+      custom::vector<int32_t> v = ramp<int32_t>(10);
+      // exercise
+      int32_t d = custom::dot(v, v);
+      // verify
+      assertUnit(d == 285);
+   }  // teardown
+
+   // floats
+   void test_dot_float()
+   {  // setup
+      custom::vector<float> v = ramp<float>(10);
+      custom::vector<float> w(10, 2.0f);
+      // exercise
+      float d = custom::dot(v, w);
+      // verify
+      assertUnit(d == 90.0f);
+   }  // teardown
+
+   // doubles
+   void test_dot_double()
+   {  // setup
+      custom::vector<double> v = ramp<double>(11);
+      // exercise
+      double d = custom::dot(v, v);
+      // verify
+      assertUnit(d == 385.0);
+   }  // teardown
+
+   /***************************************
+    * SCALAR FALLBACK
+    ***************************************/
+
+   // types without a SIMD kernel use the plain loops
+   void test_sum_long()
+   {  // setup
+      custom::vector<long long> v = ramp<long long>(101);
+      // exercise
+      long long s = custom::sum(v);
+      // verify
+      assertUnit(s == 5050);
+      assertUnit(custom::count(v, 50LL) == 1);
+      assertUnit(*custom::max_element(v) == 100);
+   }  // teardown
+
+private:
+   // 0, 1, 2, ... num-1
+   template <typename T>
+   custom::vector<T> ramp(size_t num)
+   {
+      custom::vector<T> v;
+      v.reserve(num);
+      for (size_t i = 0; i < num; i++)
+         v.push_back((T)i);
+      return v;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,384 @@
+/***********************************************************************
+ * Header:
+ *    TEST VECTOR SORT
+ * Summary:
+ *    Unit tests for custom::sort and custom::sort_by_key
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "vector_sort.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TestVectorSort : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Radix key
+      test_radixKey_signed();
+      test_radixKey_float();
+
+      // Radix sort
+      test_sort_empty();
+      test_sort_uint32();
+      test_sort_uint64();
+      test_sort_int32Negative();
+      test_sort_float();
+      test_sort_double();
+      test_sort_longDouble();
+      test_sort_bool();
+      test_sortByKey_stable();
+      test_spy_sortByKeyMovesOnce();
+
+      // Comparison sort
+      test_sort_stringsDescending();
+
+      // Parallel
+      test_parallel_radixChunks();
+      test_parallel_compareOddChunks();
+      test_parallel_throwReachesCaller();
+      test_sort_million();
+
+      report("VectorSort");
+   }
+
+   /***************************************
+    * RADIX KEY
+    ***************************************/
+
+   // -1 < 0 < 1 once the sign bit is flipped
+   void test_radixKey_signed()
+   {  // setup
+      typedef custom::sorting::radix_key<int32_t> key;
+      // exercise
+      // verify
+      assertUnit(key::map(-2147483647 - 1) == 0);
+      assertUnit(key::map(-1) < key::map(0));
+      assertUnit(key::map(0) < key::map(1));
+   }  // teardown
+
+   // -2.5 < -0.0 < 0.0 < 1.5
+   void test_radixKey_float()
+   {  // setup
+      typedef custom::sorting::radix_key<float> key;
+      // exercise
+      // verify
+      assertUnit(key::map(-2.5f) < key::map(-1.0f));
+      assertUnit(key::map(-1.0f) < key::map(-0.0f));
+      assertUnit(key::map(-0.0f) < key::map(0.0f));
+      assertUnit(key::map(0.0f) < key::map(1.5f));
+   }  // teardown
+
+   /***************************************
+    * RADIX SORT
+    ***************************************/
+
+   // nothing to sort
+   void test_sort_empty()
+   {  // setup
+      custom::vector<uint32_t> v;
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   // agrees with std::sort
+   void test_sort_uint32()
+   {  // setup
+      custom::vector<uint32_t> v;
+      std::vector<uint32_t> vExpected;
+      uint32_t x = 26;
+      for (int i = 0; i < 10000; i++)
+      {
+         x = x * 1664525u + 1013904223u;
+         v.push_back(x);
+         vExpected.push_back(x);
+      }
+      std::sort(vExpected.begin(), vExpected.end());
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(sameAs(v, vExpected));
+   }  // teardown
+
+   // keys that only differ in the top bytes
+   void test_sort_uint64()
+   {  // setup
+      custom::vector<uint64_t> v{ uint64_t(3) << 56, uint64_t(1) << 60, 49, uint64_t(2) << 56, 26 };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == uint64_t(2) << 56);
+      assertUnit(v[3] == uint64_t(3) << 56);
+      assertUnit(v[4] == uint64_t(1) << 60);
+   }  // teardown
+
+   // negatives come first
+   void test_sort_int32Negative()
+   {  // setup
+      custom::vector<int32_t> v{ 49, -26, 0, -2147483647 - 1, 2147483647, -1 };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == -2147483647 - 1);
+      assertUnit(v[1] == -26);
+      assertUnit(v[2] == -1);
+      assertUnit(v[3] == 0);
+      assertUnit(v[4] == 49);
+      assertUnit(v[5] == 2147483647);
+   }  // teardown
+
+   // floats, negative and positive
+   void test_sort_float()
+   {  // setup
+      custom::vector<float> v{ 2.5f, -0.5f, 100.0f, -100.0f, 0.0f, 1.0f };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == -100.0f);
+      assertUnit(v[1] == -0.5f);
+      assertUnit(v[2] == 0.0f);
+      assertUnit(v[3] == 1.0f);
+      assertUnit(v[4] == 2.5f);
+      assertUnit(v[5] == 100.0f);
+   }  // teardown
+
+   // doubles agree with std::sort
+   void test_sort_double()
+   {  // setup
+      custom::vector<double> v;
+      std::vector<double> vExpected;
+      uint32_t x = 49;
+      for (int i = 0; i < 5000; i++)
+      {
+         x = x * 1664525u + 1013904223u;
+         double d = ((double)x - 2147483648.0) / 1024.0;
+         v.push_back(d);
+         vExpected.push_back(d);
+      }
+      std::sort(vExpected.begin(), vExpected.end());
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(sameAs(v, vExpected));
+   }  // teardown
+
+   // no radix key for long double: it falls back to <
+   void test_sort_longDouble()
+   {  // setup
+      custom::vector<long double> v{ 2.5L, -1.0L, 0.0L, 67.0L, -49.5L };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(!custom::sorting::has_radix_key<long double>::value);
+      assertUnit(custom::sorting::has_radix_key<double>::value);
+      assertUnit(v.size() == 5);
+      assertUnit(v[0] == -49.5L);
+      assertUnit(v[1] == -1.0L);
+      assertUnit(v[2] == 0.0L);
+      assertUnit(v[3] == 2.5L);
+      assertUnit(v[4] == 67.0L);
+   }  // teardown
+
+   // flags sort by counting
+   void test_sort_bool()
+   {  // setup
+      custom::bit_vector<> v{ true, false, true, false, false };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v.size() == 5);
+      assertUnit(v[0] == false);
+      assertUnit(v[2] == false);
+      assertUnit(v[3] == true);
+      assertUnit(v[4] == true);
+   }  // teardown
+
+   // equal keys keep their order
+   void test_sortByKey_stable()
+   {  // setup
+      struct record
+      {
+         uint32_t key;
+         int value;
+      };
+      custom::vector<record> v;
+      for (int i = 0; i < 300; i++)
+         v.push_back(record{ uint32_t(i % 3), i });
+      // exercise
+      custom::sort_by_key(v, [](const record & r) { return r.key; });
+      // verify
+      assertUnit(v[0].key == 0 && v[0].value == 0);
+      assertUnit(v[1].key == 0 && v[1].value == 3);
+      assertUnit(v[99].key == 0 && v[99].value == 297);
+      assertUnit(v[100].key == 1 && v[100].value == 1);
+      assertUnit(v[299].key == 2 && v[299].value == 299);
+   }  // teardown
+
+   // elements memcpy cannot copy are moved into place, never copied
+   void test_spy_sortByKeyMovesOnce()
+   {  // setup
+      custom::vector<Spy> v;
+      v.reserve(4);
+      v.push_back(Spy(89));
+      v.push_back(Spy(26));
+      v.push_back(Spy(67));
+      v.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::sort_by_key(v, [](const Spy & s) { return s.get(); });
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopyMove() == 4);       // into the sorted buffer
+      assertUnit(Spy::numAssignMove() == 4);     // and back
+      assertUnit(v[0] == Spy(26));
+      assertUnit(v[1] == Spy(49));
+      assertUnit(v[2] == Spy(67));
+      assertUnit(v[3] == Spy(89));
+   }  // teardown
+
+   /***************************************
+    * COMPARISON SORT
+    ***************************************/
+
+   // any comparison works
+   void test_sort_stringsDescending()
+   {  // setup
+      custom::vector<std::string> v{ "b", "d", "a", "c" };
+      // exercise
+      custom::sort(v, std::greater<std::string>());
+      // verify
+      assertUnit(v[0] == "d");
+      assertUnit(v[1] == "c");
+      assertUnit(v[2] == "b");
+      assertUnit(v[3] == "a");
+   }  // teardown
+
+   /***************************************
+    * PARALLEL
+    ***************************************/
+
+   // four radix-sorted chunks merged on four threads
+   void test_parallel_radixChunks()
+   {  // setup
+      custom::vector<uint32_t> v;
+      std::vector<uint32_t> vExpected;
+      uint32_t x = 67;
+      for (int i = 0; i < 1001; i++)
+      {
+         x = x * 1664525u + 1013904223u;
+         v.push_back(x % 5000);
+         vExpected.push_back(x % 5000);
+      }
+      std::sort(vExpected.begin(), vExpected.end());
+      custom::sorting::identity key;
+      // exercise
+      custom::sorting::parallel_sort(&v[0], v.size(), 4,
+         [key](uint32_t * p, size_t n) { custom::sorting::radix_sort(p, n, key); },
+         std::less<uint32_t>());
+      // verify
+      assertUnit(sameAs(v, vExpected));
+   }  // teardown
+
+   // three chunks: the odd one out waits a round before it is merged
+   void test_parallel_compareOddChunks()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 100; i++)
+         v.push_back((i * 37) % 100);
+      // exercise
+      custom::sorting::parallel_sort(&v[0], v.size(), 3,
+         [](int * p, size_t n) { std::sort(p, p + n); },
+         std::less<int>());
+      // verify
+      bool sorted = true;
+      for (int i = 0; i < 100; i++)
+         sorted = sorted && v[i] == i;
+      assertUnit(sorted);
+   }  // teardown
+
+   // a comparison that throws on a worker thread is rethrown here
+   void test_parallel_throwReachesCaller()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back((i + 100) % 1000);
+      bool threw = false;
+      // exercise: 999 sits at [899], in the last of the four chunks
+      try
+      {
+         custom::sorting::parallel_sort(&v[0], v.size(), 4,
+            [](int * p, size_t n)
+            {
+               std::sort(p, p + n, [](int lhs, int rhs)
+               {
+                  if (lhs == 999 || rhs == 999)
+                     throw std::runtime_error("no 999s");
+                  return lhs < rhs;
+               });
+            },
+            std::less<int>());
+      }
+      catch (const std::runtime_error &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(v.size() == 1000);
+   }  // teardown
+
+   // big enough to use every hardware thread
+   void test_sort_million()
+   {  // setup
+      custom::vector<uint32_t> v;
+      std::vector<uint32_t> vExpected;
+      v.reserve(1000000);
+      vExpected.reserve(1000000);
+      uint32_t x = 89;
+      for (int i = 0; i < 1000000; i++)
+      {
+         x = x * 1664525u + 1013904223u;
+         v.push_back(x);
+         vExpected.push_back(x);
+      }
+      std::sort(vExpected.begin(), vExpected.end());
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(sameAs(v, vExpected));
+   }  // teardown
+
+private:
+   // same elements in the same order
+   template <class T>
+   bool sameAs(custom::vector<T> & v, const std::vector<T> & vExpected)
+   {
+      if (v.size() != vExpected.size())
+         return false;
+      for (size_t i = 0; i < v.size(); i++)
+         if (!(v[i] == vExpected[i]))
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -15,6 +15,7 @@
  *    This will contain the class definition of:
  *        vector                 : A class that represents a Vector
  *        vector::iterator       : An interator through Vector
+ *        vector::const_iterator : The read-only version of vector::iterator
  * Author
  *    <your names here>
  ************************************************************************/
@@ -24,60 +25,161 @@
 #include <cassert>  // because I am paranoid
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
+#include <utility>  // for std::move_if_noexcept
+#include <type_traits> // for std::is_trivially_copyable
+#include <cstring>  // for std::memcpy and std::memmove
+#include <iterator> // for std::reverse_iterator and std::distance
+#include <cstddef>  // for std::ptrdiff_t
+#include <algorithm> // for std::rotate and std::move
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
 class TestPQueue;
 class TestHash;
+class TestMmapAllocator;
 
 namespace custom
 {
 
+template <typename T, size_t N>
+class small_vector;
+
+/*****************************************
+ * GROWTH POLICIES
+ * How far vector's buffer grows when push_back or
+ * emplace runs out of room.  grow() is handed the
+ * current capacity, the smallest capacity that will
+ * do, and sizeof(T); it returns the new capacity
+ ****************************************/
+
+// 1, 2, 4, 8, ...: fewest reallocations, up to half the buffer unused
+struct growth_doubling
+{
+   static size_t grow(size_t capacity, size_t minimum, size_t /* elementSize */)
+   {
+      size_t newCapacity = (capacity == 0 ? 1 : capacity * 2);
+      return newCapacity < minimum ? minimum : newCapacity;
+   }
+};
+
+// 1, 2, 3, 4, 6, 9, 13, ...: more reallocations, a third less waste
+struct growth_one_and_a_half
+{
+   static size_t grow(size_t capacity, size_t minimum, size_t /* elementSize */)
+   {
+      size_t newCapacity = capacity + capacity / 2;
+      if (newCapacity <= capacity)
+         newCapacity = capacity + 1;
+      return newCapacity < minimum ? minimum : newCapacity;
+   }
+};
+
+// double, then round the byte count up to the allocator's size class
+// (multiples of 16, then four classes per power of two) so the slack
+// the allocator hands out anyway becomes usable capacity
+struct growth_size_class
+{
+   static size_t grow(size_t capacity, size_t minimum, size_t elementSize)
+   {
+      size_t newCapacity = growth_doubling::grow(capacity, minimum, elementSize);
+      size_t bytes = newCapacity * elementSize;
+      size_t sizeClass = 16;
+      if (bytes > sizeClass) {
+         size_t power = 16;
+         while (power * 2 < bytes)
+            power *= 2;
+         size_t step = (power / 4 < 16 ? 16 : power / 4);
+         sizeClass = (bytes + step - 1) / step * step;
+      }
+      return sizeClass / elementSize;
+   }
+};
+
+// fixed steps of Increment elements: bounded waste for memory-capped
+// services, at the price of O(n) reallocations
+template <size_t Increment>
+struct growth_fixed
+{
+   static_assert(Increment > 0, "growth_fixed needs a positive increment");
+   static size_t grow(size_t capacity, size_t minimum, size_t /* elementSize */)
+   {
+      size_t newCapacity = capacity + Increment;
+      return newCapacity < minimum ? minimum : newCapacity;
+   }
+};
+
 /*****************************************
  * VECTOR
- * Just like the std :: vector <T> class
+ * Just like the std :: vector <T, A> class.  All
+ * storage comes from the allocator A; G is the growth
+ * policy used when the buffer is full
  ****************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>, typename G = growth_doubling>
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
+   friend class ::TestMmapAllocator;
 public:
+
+   typedef T value_type;
+   typedef A allocator_type;
    
    //
    // Construct
    //
 
-   vector();
-   vector(size_t numElements                );
-   vector(size_t numElements, const T & t   );
-   vector(const std::initializer_list<T>& l );
+   vector(const A & a = A());
+   vector(size_t numElements,                const A & a = A());
+   vector(size_t numElements, const T & t,   const A & a = A());
+   vector(const std::initializer_list<T>& l, const A & a = A());
    vector(const vector &  rhs);
-   vector(      vector && rhs);
+   vector(      vector && rhs) noexcept;
    ~vector();
 
    //
    // Assign
    //
 
-   void swap(vector& rhs)
+   void swap(vector& rhs) noexcept
    {
+       if (traits::propagate_on_container_swap::value) {
+           std::swap(alloc, rhs.alloc);
+       }
        std::swap(data, rhs.data);
        std::swap(numCapacity, rhs.numCapacity);
        std::swap(numElements, rhs.numElements);
    }
    vector & operator = (const vector & rhs);
-   vector& operator = (vector&& rhs);
+   vector& operator = (vector&& rhs)
+      noexcept(traits::propagate_on_container_move_assignment::value ||
+               traits::is_always_equal::value);
 
    //
    // Iterator
    //
 
-   class iterator;
+   template <class U>
+   class basic_iterator;
+   typedef basic_iterator <T>                     iterator;
+   typedef basic_iterator <const T>               const_iterator;
+   typedef std::reverse_iterator <iterator>       reverse_iterator;
+   typedef std::reverse_iterator <const_iterator> const_reverse_iterator;
+
     iterator       begin() { return iterator(data); }
     iterator        end() { return iterator(data + numElements); }
+    const_iterator begin()  const { return const_iterator(data); }
+    const_iterator end()    const { return const_iterator(data + numElements); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend()   const { return end(); }
+    reverse_iterator       rbegin()        { return reverse_iterator(end()); }
+    reverse_iterator       rend()          { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin()  const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend()    const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend()   const { return rend(); }
 
    //
    // Access
@@ -96,6 +198,16 @@ public:
 
    void push_back(const T& t);
    void push_back(T&& t);
+   template <class ... Args>
+   T& emplace_back(Args&& ... args);
+   template <class ... Args>
+   iterator emplace(iterator pos, Args&& ... args);
+   iterator insert(const_iterator pos, const T& t);
+   iterator insert(const_iterator pos, T&& t);
+   iterator insert(const_iterator pos, size_t num, const T& t);
+   template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+   iterator insert(const_iterator pos, InputIt first, InputIt last);
+   iterator insert(const_iterator pos, const std::initializer_list<T>& l) { return insert(pos, l.begin(), l.end()); }
    void reserve(size_t newCapacity);
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
@@ -106,15 +218,19 @@ public:
 
    void clear()
    {
+       destroy(0, numElements);
        numElements = 0;
    }
    void pop_back()
    {
        if (numElements > 0) {
            --numElements;
+           destroy(numElements, numElements + 1);
        }
        
    }
+   iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+   iterator erase(const_iterator first, const_iterator last);
    void shrink_to_fit();
 
    //
@@ -124,6 +240,16 @@ public:
     size_t  size()          const { return numElements;}
     size_t  capacity()      const { return numCapacity;}
     bool empty()            const { return numElements == 0;}
+    A get_allocator()       const { return alloc;}
+
+   // bytes of element storage held from the allocator, and how
+   // many of them hold live elements
+   struct memory
+   {
+      size_t reserved;
+      size_t used;
+   };
+   memory memory_usage() const { return { numCapacity * sizeof(T), numElements * sizeof(T) }; }
    
    // adjust the size of the buffer
    
@@ -131,6 +257,43 @@ public:
    
 private:
    
+   // raw storage: slots [0, numElements) hold live objects, the rest
+   // of the capacity is uninitialized memory
+   typedef std::allocator_traits<A> traits;
+
+   T * allocate(size_t num);
+   void deallocate(T * p, size_t num);
+   void destroy(size_t begin, size_t end);
+   void uninitializedCopy(const T * src, size_t num, T * dest);
+   void uninitializedCopy(const T * src, size_t num, T * dest, std::true_type);
+   void uninitializedCopy(const T * src, size_t num, T * dest, std::false_type);
+   void uninitializedMove(T * src, size_t num, T * dest);
+   void uninitializedMove(T * src, size_t num, T * dest, std::true_type);
+   void uninitializedMove(T * src, size_t num, T * dest, std::false_type);
+   void reallocate(size_t newCapacity);
+   bool expandInPlace(size_t newCapacity);
+   template <class AA>
+   static auto expand(AA & a, T * p, size_t num, size_t newNum, int)
+      -> decltype(a.expand(p, num, newNum)) { return a.expand(p, num, newNum); }
+   template <class AA>
+   static bool expand(AA &, T *, size_t, size_t, long) { return false; }
+   size_t growCapacity() const { return G::grow(numCapacity, numElements + 1, sizeof(T)); }
+   template <class ... Args>
+   void reallocateAppend(Args && ... args);
+   template <class Build>
+   iterator insertWith(size_t index, size_t num, Build build);
+   template <class Build>
+   void insertInPlace(size_t index, size_t num, Build build, std::true_type);
+   template <class Build>
+   void insertInPlace(size_t index, size_t num, Build build, std::false_type);
+   template <class InputIt>
+   iterator insertRange(size_t index, InputIt first, InputIt last, std::input_iterator_tag);
+   template <class ForwardIt>
+   iterator insertRange(size_t index, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+   void eraseShift(size_t index, size_t num, std::true_type);
+   void eraseShift(size_t index, size_t num, std::false_type);
+
+   A    alloc;                // hands out uninitialized storage
    T *  data;                 // user data, a dynamically-allocated array
    size_t  numCapacity;       // the capacity of the array
    size_t  numElements;       // the number of items currently used
@@ -138,77 +301,127 @@ private:
 
 /**************************************************
  * VECTOR ITERATOR
- * An iterator through vector.  You only need to
- * support the following:
- *   1. Constructors (default and copy)
- *   2. Not equals operator
- *   3. Increment (prefix and postfix)
- *   4. Dereference
- * This particular iterator is a bi-directional meaning
- * that ++ and -- both work.  Not all iterators are that way.
+ * A random-access iterator through vector: it is
+ * just a pointer, so it supports everything a
+ * pointer does and the std algorithms (sort,
+ * lower_bound, distance, ...) get the fast paths.
+ * U is T for iterator and const T for const_iterator
  *************************************************/
-template <typename T>
-class vector <T> ::iterator
+template <typename T, typename A, typename G>
+template <class U>
+class vector <T, A, G> :: basic_iterator
 {
+   friend class vector <T, A, G>;
+   template <class UU>
+   friend class basic_iterator;
+   template <typename TT, size_t N>
+   friend class small_vector;
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
 public:
+   typedef std::random_access_iterator_tag iterator_category;
+#ifdef __cpp_lib_concepts
+   typedef std::contiguous_iterator_tag    iterator_concept;
+#endif
+   typedef typename std::remove_const<U>::type value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef U *                             pointer;
+   typedef U &                             reference;
+
    // constructors, destructors, and assignment operator
-   iterator()                           { this->p = nullptr; }
-   iterator(T* p)                       { this->p = p; }
-   iterator(const iterator& rhs)        { this->p = rhs.p; }
-    iterator(size_t index, vector<T>& v) { this->p = &v.data[index]; }
-   iterator& operator = (const iterator& rhs)
+   basic_iterator()                           { this->p = nullptr; }
+   basic_iterator(U* p)                       { this->p = p; }
+   basic_iterator(const basic_iterator& rhs)  { this->p = rhs.p; }
+    basic_iterator(size_t index, vector<T, A, G>& v) { this->p = &v.data[index]; }
+   basic_iterator& operator = (const basic_iterator& rhs)
    {
       p = rhs.p;
       return *this;
    }
 
-    
-   // equals, not equals operator
-   bool operator != (const iterator& rhs) const { return p != rhs.p; }
-   bool operator == (const iterator& rhs) const { return p == rhs.p; }
-
-   // dereference operator
-   T& operator * ()
+   // an iterator converts to a const_iterator, never the other way
+   template <class UU, class = typename std::enable_if<
+      std::is_same<UU, T>::value && std::is_same<U, const T>::value>::type>
+   basic_iterator(const basic_iterator<UU>& rhs) { this->p = rhs.p; }
+
+   // comparison operators.  Friends, so an iterator and
+   // a const_iterator can be compared either way around
+   friend bool operator == (const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.p == rhs.p; }
+   friend bool operator != (const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.p != rhs.p; }
+   friend bool operator <  (const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.p <  rhs.p; }
+   friend bool operator >  (const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.p >  rhs.p; }
+   friend bool operator <= (const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.p <= rhs.p; }
+   friend bool operator >= (const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.p >= rhs.p; }
+
+   // dereference operators
+   U& operator * () const
    {
       return *(p);
    }
+   U* operator -> () const
+   {
+      return p;
+   }
+   U& operator [] (difference_type n) const
+   {
+      return p[n];
+   }
 
    // prefix increment
-   iterator& operator ++ ()
+   basic_iterator& operator ++ ()
    {
        ++p;
       return *this;
    }
 
    // postfix increment
-   iterator operator ++ (int postfix)
+   basic_iterator operator ++ (int postfix)
    {
-       iterator tmp = *this;
+       basic_iterator tmp = *this;
        ++p;
       return tmp;
    }
 
    // prefix decrement
-   iterator& operator -- ()
+   basic_iterator& operator -- ()
    {
        --p;
       return *this;
    }
 
    // postfix decrement
-   iterator operator -- (int postfix)
+   basic_iterator operator -- (int postfix)
    {
-       iterator tmp = *this;
+       basic_iterator tmp = *this;
        --p;
       return tmp;
    }
 
+   // jump n elements at once
+   basic_iterator& operator += (difference_type n)
+   {
+      p += n;
+      return *this;
+   }
+   basic_iterator& operator -= (difference_type n)
+   {
+      p -= n;
+      return *this;
+   }
+   friend basic_iterator operator + (basic_iterator it, difference_type n) { return it += n; }
+   friend basic_iterator operator + (difference_type n, basic_iterator it) { return it += n; }
+   friend basic_iterator operator - (basic_iterator it, difference_type n) { return it -= n; }
+
+   // how many elements apart two iterators are
+   friend difference_type operator - (const basic_iterator& lhs, const basic_iterator& rhs)
+   {
+      return lhs.p - rhs.p;
+   }
+
 private:
-   T* p;
+   U* p;
 };
 
 /*****************************************
@@ -216,8 +429,8 @@ private:
  * Default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector()
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(const A & a) : alloc(a)
 {
     data = nullptr;
     numCapacity = 0;
@@ -229,36 +442,44 @@ vector <T> :: vector()
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num, const T & t)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(size_t num, const T & t, const A & a) : alloc(a)
 {
-    if (num == 0) {
-        data = nullptr;
-    } else {
-        data = new T[num];
-    }
-    
+    data = allocate(num);
     numCapacity = num;
-    numElements = num;
+    numElements = 0;
     
-    for (int i = 0; i < numElements; ++i) {
-        data[i] = t;
+    try {
+        for (; numElements < num; ++numElements) {
+            traits::construct(alloc, data + numElements, t);
+        }
+    } catch (...) {
+        destroy(0, numElements);
+        deallocate(data, numCapacity);
+        throw;
     }
-
 }
 
 /*****************************************
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T>
-vector <T> :: vector(const std::initializer_list<T> & l)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(const std::initializer_list<T> & l, const A & a) : alloc(a)
 {
     numCapacity = l.size();
     numElements = 0;
-    data = new T[numCapacity];
-    for (const T& element: l) {
-        data[numElements++] = element;
+    data = allocate(numCapacity);
+    
+    try {
+        for (const T& element: l) {
+            traits::construct(alloc, data + numElements, element);
+            ++numElements;
+        }
+    } catch (...) {
+        destroy(0, numElements);
+        deallocate(data, numCapacity);
+        throw;
     }
 }
 
@@ -267,16 +488,22 @@ vector <T> :: vector(const std::initializer_list<T> & l)
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(size_t num, const A & a) : alloc(a)
 {
-    if (num == 0) {
-        data = nullptr;
-    } else {
-        data = new T[num];
-    }
+    data = allocate(num);
     numCapacity = num;
-    numElements = num;
+    numElements = 0;
+    
+    try {
+        for (; numElements < num; ++numElements) {
+            traits::construct(alloc, data + numElements);
+        }
+    } catch (...) {
+        destroy(0, numElements);
+        deallocate(data, numCapacity);
+        throw;
+    }
 }
 
 /*****************************************
@@ -284,29 +511,29 @@ vector <T> :: vector(size_t num)
  * Allocate the space for numElements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T>
-vector <T> :: vector (const vector & rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (const vector & rhs)
+   : alloc(traits::select_on_container_copy_construction(rhs.alloc))
 {
     numCapacity = rhs.numElements;
-    numElements = rhs.numElements;
-    if (rhs.numCapacity == 0) {
-        data = nullptr;
-    }
-    else {
-        data = new T[numCapacity];
-    }
+    numElements = 0;
+    data = allocate(numCapacity);
 
-    for (size_t i = 0; i < numElements; ++i) {
-        data[i] = rhs.data[i];
+    try {
+        uninitializedCopy(rhs.data, rhs.numElements, data);
+    } catch (...) {
+        deallocate(data, numCapacity);
+        throw;
     }
+    numElements = rhs.numElements;
 }
 
 /*****************************************
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
  ****************************************/
-template <typename T>
-vector <T> :: vector (vector && rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (vector && rhs) noexcept : alloc(std::move(rhs.alloc))
 {
     
     numCapacity = rhs.numCapacity;
@@ -324,10 +551,11 @@ vector <T> :: vector (vector && rhs)
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T>
-vector <T> :: ~vector()
+template <typename T, typename A, typename G>
+vector <T, A, G> :: ~vector()
 {
-    delete[] data;
+    destroy(0, numElements);
+    deallocate(data, numCapacity);
 }
 
 
@@ -338,67 +566,40 @@ vector <T> :: ~vector()
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: resize(size_t newElements)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize(size_t newElements)
 {
-    if (newElements == numElements) {
+    if (newElements < numElements) {
+        destroy(newElements, numElements);
+        numElements = newElements;
         return;
     }
     
-    if (newElements < numElements) {
-        numElements = newElements;
-    } else if (newElements > numCapacity) {
-        T* new_data = new T[newElements];
-        
-        for (size_t i = 0; i < numElements; ++i) {
-            new_data[i] = data[i];
-        }
-        
-        delete[] data;
-        
-        data = new_data;
-        numCapacity = newElements;
-        numElements = newElements;
-    } else {
-        numElements = newElements;
+    if (newElements > numCapacity) {
+        reallocate(newElements);
+    }
+    
+    for (; numElements < newElements; ++numElements) {
+        traits::construct(alloc, data + numElements);
     }
 }
 
-template <typename T>
-void vector <T> :: resize(size_t newElements, const T & t)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize(size_t newElements, const T & t)
 {
-    if (newElements == numElements) {
-        return;
-    }
-    
     if (newElements < numElements) {
+        destroy(newElements, numElements);
         numElements = newElements;
         return;
     }
     
     if (newElements > numCapacity) {
-        T* new_data = new T[newElements];
-        
-        for (size_t i = 0; i < numElements; ++i) {
-            new_data[i] = data[i];
-        }
-        
-        for (size_t i = numElements; i < newElements; ++i) {
-            new_data[i] = t;
-        }
-        
-        delete[] data;
-        
-        data = new_data;
-        
-        numCapacity = newElements;
-        
-    } else {
-        for (size_t i = numElements; i < newElements; ++i) {
-            data[i] = t;
-        }
+        reallocate(newElements);
+    }
+    
+    for (; numElements < newElements; ++numElements) {
+        traits::construct(alloc, data + numElements, t);
     }
-    numElements = newElements;
 }
 
 /***************************************
@@ -409,36 +610,35 @@ void vector <T> :: resize(size_t newElements, const T & t)
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: reserve(size_t newCapacity)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: reserve(size_t newCapacity)
 {
     if (newCapacity > numCapacity) {
-        
-        T* newData = new T[newCapacity];
-        
-        for (size_t i = 0; i < numElements; ++i) {
-            newData[i] = data[i];
-        }
-        
-        delete[] data;
-        data = newData;
-        numCapacity = newCapacity;
+        reallocate(newCapacity);
     }
 }
 
 /***************************************
  * VECTOR :: SHRINK TO FIT
- * Get rid of any extra capacity
+ * Get rid of any extra capacity: move the elements
+ * into a buffer of exactly numElements and give the
+ * old one back to the allocator
  *     INPUT  :
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: shrink_to_fit()
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: shrink_to_fit()
 {
-    numCapacity = numElements;
-    if (numCapacity == 0) {
+    if (numElements == numCapacity) {
+        return;
+    }
+    if (numElements == 0) {
+        deallocate(data, numCapacity);
         data = nullptr;
+        numCapacity = 0;
+        return;
     }
+    reallocate(numElements);
 }
 
 
@@ -447,8 +647,8 @@ void vector <T> :: shrink_to_fit()
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: operator [] (size_t index)
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: operator [] (size_t index)
 {
     return data[index];
    
@@ -458,8 +658,8 @@ T & vector <T> :: operator [] (size_t index)
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: operator [] (size_t index) const
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: operator [] (size_t index) const
 {
     return data[index];
 }
@@ -468,8 +668,8 @@ const T & vector <T> :: operator [] (size_t index) const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: front ()
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: front ()
 {
    
    return data[0];
@@ -479,8 +679,8 @@ T & vector <T> :: front ()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: front () const
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: front () const
 {
    return data[0];
 }
@@ -489,8 +689,8 @@ const T & vector <T> :: front () const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: back()
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: back()
 {
    return data[numElements - 1];
 }
@@ -499,8 +699,8 @@ T & vector <T> :: back()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: back() const
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: back() const
 {
     return data[numElements - 1];
 }
@@ -513,94 +713,401 @@ const T & vector <T> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-void vector <T> :: push_back (const T & t) {
-    if (numCapacity == 0) {
-        numCapacity = 1;
-        data = new T[1];
-    } else if (numElements >= numCapacity) {
-        numCapacity *= 2;
-        T* new_data = new T[numCapacity];
-        
-        for (int i = 0; i < numElements; ++i) {
-            new_data[i] = data[i];
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: push_back (const T & t) {
+    emplace_back(t);
+}
+
+template <typename T, typename A, typename G>
+void vector <T, A, G> ::push_back(T && t)
+{
+    emplace_back(std::move(t));
+}
+
+/***************************************
+ * VECTOR :: EMPLACE BACK
+ * Build a new element at the end of the buffer
+ * straight from args, with no temporary.  The
+ * buffer grows as needed
+ *     INPUT  : args for one of T's constructors
+ *     OUTPUT : the new element
+ **************************************/
+template <typename T, typename A, typename G>
+template <class ... Args>
+T & vector <T, A, G> :: emplace_back(Args && ... args)
+{
+    if (numElements == numCapacity) {
+        reallocateAppend(std::forward<Args>(args)...);
+    } else {
+        traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+        ++numElements;
+    }
+    return data[numElements - 1];
+}
+
+/***************************************
+ * VECTOR :: EMPLACE
+ * Build a new element in front of pos.  At the end
+ * this is emplace_back; elsewhere the new value is
+ * built first (args may point into our buffer) and
+ * the tail is shifted up one slot by moves
+ *     INPUT  : pos where the new element goes
+ *              args for one of T's constructors
+ *     OUTPUT : iterator to the new element
+ **************************************/
+template <typename T, typename A, typename G>
+template <class ... Args>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: emplace(iterator pos, Args && ... args)
+{
+    size_t index = pos.p - data;
+    assert(index <= numElements);
+    
+    if (index == numElements) {
+        emplace_back(std::forward<Args>(args)...);
+        return iterator(data + index);
+    }
+    
+    T t(std::forward<Args>(args)...);
+    if (numElements == numCapacity) {
+        reallocate(growCapacity());
+    }
+    
+    traits::construct(alloc, data + numElements, std::move(data[numElements - 1]));
+    ++numElements;
+    for (size_t i = numElements - 2; i > index; --i) {
+        data[i] = std::move(data[i - 1]);
+    }
+    data[index] = std::move(t);
+    return iterator(data + index);
+}
+
+/***************************************
+ * VECTOR :: INSERT
+ * Put new elements in front of pos: one copy of t,
+ * num copies of t, or the range [first, last).  The
+ * buffer grows at most once, except for a range of
+ * single-pass iterators, whose length is unknown
+ * until it has been read
+ *     INPUT  : pos where the new elements go
+ *     OUTPUT : iterator to the first new element
+ **************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insert(const_iterator pos, const T & t)
+{
+    // t may live in our own buffer, so copy it before anything moves
+    T value(t);
+    return insertWith(pos.p - data, 1, [&](T * dest) {
+        traits::construct(alloc, dest, std::move(value));
+    });
+}
+
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insert(const_iterator pos, T && t)
+{
+    T value(std::move(t));
+    return insertWith(pos.p - data, 1, [&](T * dest) {
+        traits::construct(alloc, dest, std::move(value));
+    });
+}
+
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insert(const_iterator pos, size_t num, const T & t)
+{
+    T value(t);
+    return insertWith(pos.p - data, num, [&](T * dest) {
+        size_t i = 0;
+        try {
+            for (; i < num; ++i) {
+                traits::construct(alloc, dest + i, value);
+            }
+        } catch (...) {
+            while (i > 0) {
+                traits::destroy(alloc, dest + --i);
+            }
+            throw;
         }
-        
-        //delete[] data;
-        
-        data = new_data;
-    }
-    data[numElements++] = t;
-}
-
-template <typename T>
-void vector <T> ::push_back(T && t)
-{
-    if (numCapacity == 0) {
-        numCapacity = 1;
-        data = new T[1];
-    } else if (numElements >= numCapacity) {
-        numCapacity *= 2;
-        T* new_data = new T[numCapacity];
-        
-        for (int i = 0; i < numElements; ++i) {
-            new_data[i] = data[i];
+    });
+}
+
+template <typename T, typename A, typename G>
+template <class InputIt, class>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insert(const_iterator pos, InputIt first, InputIt last)
+{
+    return insertRange(pos.p - data, first, last,
+                       typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+/***************************************
+ * VECTOR :: INSERT RANGE
+ * Forward iterators can be measured first, so the
+ * range goes in with insertWith.  Single-pass ones
+ * are appended one at a time and rotated into place
+ **************************************/
+template <typename T, typename A, typename G>
+template <class ForwardIt>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insertRange(size_t index, ForwardIt first, ForwardIt last,
+                                                                       std::forward_iterator_tag)
+{
+    size_t num = std::distance(first, last);
+    return insertWith(index, num, [&](T * dest) {
+        size_t i = 0;
+        try {
+            for (ForwardIt it = first; i < num; ++it, ++i) {
+                traits::construct(alloc, dest + i, *it);
+            }
+        } catch (...) {
+            while (i > 0) {
+                traits::destroy(alloc, dest + --i);
+            }
+            throw;
         }
-        
-        //delete[] data;
-        
-        data = new_data;
+    });
+}
+
+template <typename T, typename A, typename G>
+template <class InputIt>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insertRange(size_t index, InputIt first, InputIt last,
+                                                                       std::input_iterator_tag)
+{
+    assert(index <= numElements);
+    size_t oldElements = numElements;
+    try {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } catch (...) {
+        destroy(oldElements, numElements);
+        numElements = oldElements;
+        throw;
+    }
+    std::rotate(data + index, data + oldElements, data + numElements);
+    return iterator(data + index);
+}
+
+/***************************************
+ * VECTOR :: INSERT WITH
+ * Make room for num elements at index and have
+ * build construct them there.  Without room, the
+ * new buffer gets the new elements first and then
+ * every old element moved once around them
+ *     INPUT  : index where the new elements go
+ *              num   how many there are
+ *              build build(dest) constructs them all
+ *                    at dest, or throws leaving none
+ *     OUTPUT : iterator to the first new element
+ **************************************/
+template <typename T, typename A, typename G>
+template <class Build>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: insertWith(size_t index, size_t num, Build build)
+{
+    assert(index <= numElements);
+    if (num == 0) {
+        return iterator(data + index);
+    }
+    
+    if (numElements + num > numCapacity) {
+        size_t newCapacity = G::grow(numCapacity, numElements + num, sizeof(T));
+        if (!expandInPlace(newCapacity)) {
+            T * newData = allocate(newCapacity);
+            try {
+                build(newData + index);
+            } catch (...) {
+                deallocate(newData, newCapacity);
+                throw;
+            }
+            size_t numMoved = 0;
+            try {
+                uninitializedMove(data, index, newData);
+                numMoved = index;
+                uninitializedMove(data + index, numElements - index, newData + index + num);
+            } catch (...) {
+                for (size_t i = 0; i < numMoved; ++i) {
+                    traits::destroy(alloc, newData + i);
+                }
+                for (size_t i = 0; i < num; ++i) {
+                    traits::destroy(alloc, newData + index + i);
+                }
+                deallocate(newData, newCapacity);
+                throw;
+            }
+            destroy(0, numElements);
+            deallocate(data, numCapacity);
+            data = newData;
+            numCapacity = newCapacity;
+            numElements += num;
+            return iterator(data + index);
+        }
+    }
+    
+    insertInPlace(index, num, build, std::is_trivially_copyable<T>());
+    return iterator(data + index);
+}
+
+/***************************************
+ * VECTOR :: INSERT IN PLACE
+ * There is room.  Trivially copyable elements make
+ * space with one memmove; anything else is built at
+ * the end and rotated into place
+ **************************************/
+template <typename T, typename A, typename G>
+template <class Build>
+void vector <T, A, G> :: insertInPlace(size_t index, size_t num, Build build, std::true_type)
+{
+    size_t numAfter = numElements - index;
+    if (numAfter > 0) {
+        std::memmove((void *)(data + index + num), (const void *)(data + index), numAfter * sizeof(T));
+    }
+    try {
+        build(data + index);
+    } catch (...) {
+        if (numAfter > 0) {
+            std::memmove((void *)(data + index), (const void *)(data + index + num), numAfter * sizeof(T));
+        }
+        throw;
+    }
+    numElements += num;
+}
+
+template <typename T, typename A, typename G>
+template <class Build>
+void vector <T, A, G> :: insertInPlace(size_t index, size_t num, Build build, std::false_type)
+{
+    build(data + numElements);
+    numElements += num;
+    std::rotate(data + index, data + numElements - num, data + numElements);
+}
+
+/***************************************
+ * VECTOR :: ERASE
+ * Remove [first, last), closing the gap: one
+ * memmove for trivially copyable elements, move
+ * assignment for anything else
+ *     INPUT  : first, last  the elements to remove
+ *     OUTPUT : iterator to the element after them
+ **************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: iterator vector <T, A, G> :: erase(const_iterator first, const_iterator last)
+{
+    size_t index = first.p - data;
+    size_t num = last.p - first.p;
+    assert(index + num <= numElements);
+    if (num > 0) {
+        eraseShift(index, num, std::is_trivially_copyable<T>());
+        numElements -= num;
+    }
+    return iterator(data + index);
+}
+
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: eraseShift(size_t index, size_t num, std::true_type)
+{
+    size_t numAfter = numElements - index - num;
+    if (numAfter > 0) {
+        std::memmove((void *)(data + index), (const void *)(data + index + num), numAfter * sizeof(T));
     }
-    data[numElements++] = std::move(t);
-   
+}
+
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: eraseShift(size_t index, size_t num, std::false_type)
+{
+    std::move(data + index + num, data + numElements, data + index);
+    destroy(numElements - num, numElements);
 }
 
 /***************************************
  * VECTOR :: ASSIGNMENT
  * This operator will copy the contents of the
- * rhs onto *this, growing the buffer as needed
+ * rhs onto *this, reusing our buffer when it is
+ * big enough and growing it when it is not
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-vector<T>& vector<T>::operator=(const vector& rhs) {
+template <typename T, typename A, typename G>
+vector<T, A, G>& vector<T, A, G>::operator=(const vector& rhs) {
     // Check for self-assignment
     if (this == &rhs) {
         return *this;
     }
 
-    // Deallocate the existing data
-    delete[] data;
-
-    // Copy the data from rhs
-    if (numCapacity <= rhs.numCapacity) {
-        numCapacity = rhs.numCapacity;
-    }
-    numElements = rhs.numElements;
-    if (rhs.data ==  nullptr) {
+    // Our allocator is about to be replaced and cannot free what
+    // it handed out: give the buffer back while we still can
+    if (traits::propagate_on_container_copy_assignment::value && !(alloc == rhs.alloc)) {
+        destroy(0, numElements);
+        deallocate(data, numCapacity);
         data = nullptr;
-    } else {
-        data = new T[numCapacity];
+        numCapacity = 0;
+        numElements = 0;
+    }
+    if (traits::propagate_on_container_copy_assignment::value) {
+        alloc = rhs.alloc;
+    }
+
+    // Not enough room: copy into a new buffer of exactly the right
+    // size before letting go of the old one
+    if (rhs.numElements > numCapacity) {
+        T * newData = allocate(rhs.numElements);
+        try {
+            uninitializedCopy(rhs.data, rhs.numElements, newData);
+        } catch (...) {
+            deallocate(newData, rhs.numElements);
+            throw;
+        }
+        destroy(0, numElements);
+        deallocate(data, numCapacity);
+        data = newData;
+        numCapacity = rhs.numElements;
+        numElements = rhs.numElements;
+        return *this;
     }
 
-    // Copy the elements from rhs to this
-    for (size_t i = 0; i < numElements; ++i) {
+    // Room enough: assign over the elements we have, copy-construct
+    // any more, and destroy any left over.  No allocation at all
+    size_t numCommon = (numElements < rhs.numElements ? numElements : rhs.numElements);
+    for (size_t i = 0; i < numCommon; ++i) {
         data[i] = rhs.data[i];
     }
+    if (rhs.numElements > numElements) {
+        uninitializedCopy(rhs.data + numElements, rhs.numElements - numElements, data + numElements);
+    } else {
+        destroy(rhs.numElements, numElements);
+    }
+    numElements = rhs.numElements;
 
     return *this;
 }
-template <typename T>
-vector<T>& vector<T>::operator=(vector&& rhs) {
+template <typename T, typename A, typename G>
+vector<T, A, G>& vector<T, A, G>::operator=(vector&& rhs)
+   noexcept(traits::propagate_on_container_move_assignment::value ||
+            traits::is_always_equal::value) {
     // Check for self-assignment
     if (this == &rhs) {
         return *this;
     }
     
-    
+    // An allocator that stays behind and cannot free rhs's buffer
+    // means the elements have to move one at a time
+    if (!traits::propagate_on_container_move_assignment::value && !(alloc == rhs.alloc)) {
+        destroy(0, numElements);
+        numElements = 0;
+        if (rhs.numElements > numCapacity) {
+            deallocate(data, numCapacity);
+            data = nullptr;
+            numCapacity = 0;
+            data = allocate(rhs.numElements);
+            numCapacity = rhs.numElements;
+        }
+        uninitializedMove(rhs.data, rhs.numElements, data);
+        numElements = rhs.numElements;
+        rhs.clear();
+        return *this;
+    }
 
     // Deallocate the existing data
-    delete[] data;
+    destroy(0, numElements);
+    deallocate(data, numCapacity);
+    if (traits::propagate_on_container_move_assignment::value) {
+        alloc = std::move(rhs.alloc);
+    }
 
     // Move ownership of data, capacity, and size from rhs to this
     
@@ -616,8 +1123,211 @@ vector<T>& vector<T>::operator=(vector&& rhs) {
     return *this;
 }
 
+/***************************************
+ * VECTOR :: ALLOCATE
+ * Get raw storage for num elements.  Nothing is
+ * constructed; an empty request gives nullptr
+ **************************************/
+template <typename T, typename A, typename G>
+T * vector <T, A, G> :: allocate(size_t num)
+{
+    if (num == 0) {
+        return nullptr;
+    }
+    return traits::allocate(alloc, num);
+}
+
+/***************************************
+ * VECTOR :: DEALLOCATE
+ * Give back storage from allocate().  Every
+ * element in it must already be destroyed
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: deallocate(T * p, size_t num)
+{
+    if (p != nullptr) {
+        traits::deallocate(alloc, p, num);
+    }
+}
+
+/***************************************
+ * VECTOR :: DESTROY
+ * Run the destructor on data[begin..end), leaving
+ * the slots as raw storage
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: destroy(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        traits::destroy(alloc, data + i);
+    }
+}
 
+/***************************************
+ * VECTOR :: UNINITIALIZED COPY
+ * Copy-construct src[0..num) into the raw storage
+ * at dest.  Trivially copyable types are copied in
+ * one memcpy; anything else element by element, and
+ * a throw destroys what was built so far
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: uninitializedCopy(const T * src, size_t num, T * dest)
+{
+    uninitializedCopy(src, num, dest, std::is_trivially_copyable<T>());
+}
 
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: uninitializedCopy(const T * src, size_t num, T * dest, std::true_type)
+{
+    if (num > 0) {
+        std::memcpy(dest, src, num * sizeof(T));
+    }
+}
 
-} // namespace custom
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: uninitializedCopy(const T * src, size_t num, T * dest, std::false_type)
+{
+    size_t i = 0;
+    try {
+        for (; i < num; ++i) {
+            traits::construct(alloc, dest + i, src[i]);
+        }
+    } catch (...) {
+        for (size_t j = 0; j < i; ++j) {
+            traits::destroy(alloc, dest + j);
+        }
+        throw;
+    }
+}
+
+/***************************************
+ * VECTOR :: UNINITIALIZED MOVE
+ * Like uninitializedCopy, but elements are moved
+ * when T's move constructor is noexcept.  The source
+ * elements are left for the caller to destroy
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: uninitializedMove(T * src, size_t num, T * dest)
+{
+    uninitializedMove(src, num, dest, std::is_trivially_copyable<T>());
+}
+
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: uninitializedMove(T * src, size_t num, T * dest, std::true_type)
+{
+    uninitializedCopy(src, num, dest, std::true_type());
+}
+
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: uninitializedMove(T * src, size_t num, T * dest, std::false_type)
+{
+    size_t i = 0;
+    try {
+        for (; i < num; ++i) {
+            traits::construct(alloc, dest + i, std::move_if_noexcept(src[i]));
+        }
+    } catch (...) {
+        for (size_t j = 0; j < i; ++j) {
+            traits::destroy(alloc, dest + j);
+        }
+        throw;
+    }
+}
+
+/***************************************
+ * VECTOR :: REALLOCATE
+ * Move the live elements into a fresh buffer of
+ * newCapacity.  Elements are moved when T's move
+ * constructor is noexcept and copied otherwise, so
+ * a throw leaves the old buffer untouched
+ *     INPUT  : newCapacity >= numElements
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: reallocate(size_t newCapacity)
+{
+    assert(newCapacity >= numElements);
+    if (expandInPlace(newCapacity))
+        return;
+    
+    T * newData = allocate(newCapacity);
+    
+    try {
+        uninitializedMove(data, numElements, newData);
+    } catch (...) {
+        deallocate(newData, newCapacity);
+        throw;
+    }
+    
+    destroy(0, numElements);
+    deallocate(data, numCapacity);
+    data = newData;
+    numCapacity = newCapacity;
+}
+
+/***************************************
+ * VECTOR :: EXPAND IN PLACE
+ * Some allocators (see mmap_allocator.h) can grow
+ * a buffer without moving it.  Ask them first: if
+ * they agree, no element has to move at all
+ *     INPUT  : newCapacity > numCapacity
+ *     OUTPUT : true if the buffer now holds newCapacity
+ **************************************/
+template <typename T, typename A, typename G>
+bool vector <T, A, G> :: expandInPlace(size_t newCapacity)
+{
+    if (data == nullptr || newCapacity <= numCapacity)
+        return false;
+    if (!expand(alloc, data, numCapacity, newCapacity, 0))
+        return false;
+    numCapacity = newCapacity;
+    return true;
+}
 
+/***************************************
+ * VECTOR :: REALLOCATE APPEND
+ * Grow the buffer and build a new element from
+ * args at the end.  The new element is built before
+ * the old ones are moved so args may refer into our
+ * own buffer
+ *     INPUT  : args for one of T's constructors
+ **************************************/
+template <typename T, typename A, typename G>
+template <class ... Args>
+void vector <T, A, G> :: reallocateAppend(Args && ... args)
+{
+    size_t newCapacity = growCapacity();
+    if (expandInPlace(newCapacity))
+    {
+        traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+        ++numElements;
+        return;
+    }
+    
+    T * newData = allocate(newCapacity);
+    
+    try {
+        traits::construct(alloc, newData + numElements, std::forward<Args>(args)...);
+    } catch (...) {
+        deallocate(newData, newCapacity);
+        throw;
+    }
+    
+    try {
+        uninitializedMove(data, numElements, newData);
+    } catch (...) {
+        traits::destroy(alloc, newData + numElements);
+        deallocate(newData, newCapacity);
+        throw;
+    }
+    
+    destroy(0, numElements);
+    deallocate(data, numCapacity);
+    data = newData;
+    numCapacity = newCapacity;
+    ++numElements;
+}
+
+
+
+
+} // namespace custom
@@ -0,0 +1,485 @@
+/***********************************************************************
+ * Header:
+ *    VECTOR SIMD
+ * Summary:
+ *    Search and reduction loops for vectors of numbers:
+ *
+ *       custom::find(v, x)          first element equal to x
+ *       custom::count(v, x)         how many elements equal x
+ *       custom::min_element(v)      first smallest element
+ *       custom::max_element(v)      first largest element
+ *       custom::sum(v)              v[0] + v[1] + ...
+ *       custom::dot(v, w)           v[0]*w[0] + v[1]*w[1] + ...
+ *
+ *    For int32_t, float and double these run four (or two) elements
+ *    at a time with SSE2, which every x86-64 CPU has.  Everything
+ *    else, and every other CPU, gets plain loops written so the
+ *    compiler can vectorize them for whatever -march it targets.
+ *
+ *    Floating-point sums and dot products add in a different order
+ *    than a simple loop would, so the last bits can differ.  NaNs
+ *    never compare equal and are not supported by min or max.
+ *
+ *    This will contain:
+ *        simd::*                : The kernels, over a pointer and a count
+ *        find, count, ...       : The same, over a custom::vector
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <algorithm> // for std::min and std::max
+#include "vector.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUSTOM_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace custom
+{
+namespace simd
+{
+
+/*****************************************
+ * SCALAR KERNELS
+ * Any T with == and <.  The reductions keep four
+ * separate running totals so the additions do not
+ * wait on each other and the compiler may vectorize
+ ****************************************/
+template <typename T>
+const T * find(const T * p, size_t n, const T & x)
+{
+   for (size_t i = 0; i < n; i++)
+      if (p[i] == x)
+         return p + i;
+   return p + n;
+}
+
+template <typename T>
+size_t count(const T * p, size_t n, const T & x)
+{
+   size_t num = 0;
+   for (size_t i = 0; i < n; i++)
+      num += (p[i] == x);
+   return num;
+}
+
+template <typename T>
+T minValue(const T * p, size_t n)
+{
+   assert(n > 0);
+   T m = p[0];
+   for (size_t i = 1; i < n; i++)
+      m = p[i] < m ? p[i] : m;
+   return m;
+}
+
+template <typename T>
+T maxValue(const T * p, size_t n)
+{
+   assert(n > 0);
+   T m = p[0];
+   for (size_t i = 1; i < n; i++)
+      m = m < p[i] ? p[i] : m;
+   return m;
+}
+
+template <typename T>
+T sum(const T * p, size_t n)
+{
+   T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      s0 += p[i];
+      s1 += p[i + 1];
+      s2 += p[i + 2];
+      s3 += p[i + 3];
+   }
+   for (; i < n; i++)
+      s0 += p[i];
+   return (s0 + s1) + (s2 + s3);
+}
+
+template <typename T>
+T dot(const T * p, const T * q, size_t n)
+{
+   T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      s0 += p[i]     * q[i];
+      s1 += p[i + 1] * q[i + 1];
+      s2 += p[i + 2] * q[i + 2];
+      s3 += p[i + 3] * q[i + 3];
+   }
+   for (; i < n; i++)
+      s0 += p[i] * q[i];
+   return (s0 + s1) + (s2 + s3);
+}
+
+#ifdef CUSTOM_SIMD_SSE2
+
+// number of set bits in a 4-bit movemask
+inline size_t bitsInMask(int mask)
+{
+   static const unsigned char bits[16] =
+      { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+   return bits[mask & 0xF];
+}
+
+/*****************************************
+ * SSE2 KERNELS :: INT32
+ ****************************************/
+inline const int32_t * find(const int32_t * p, size_t n, const int32_t & x)
+{
+   __m128i key = _mm_set1_epi32(x);
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i)), key);
+      if (_mm_movemask_epi8(eq))
+         break;
+   }
+   for (; i < n; i++)
+      if (p[i] == x)
+         return p + i;
+   return p + n;
+}
+
+inline size_t count(const int32_t * p, size_t n, const int32_t & x)
+{
+   __m128i key = _mm_set1_epi32(x);
+   size_t num = 0;
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i)), key);
+      num += bitsInMask(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+   }
+   for (; i < n; i++)
+      num += (p[i] == x);
+   return num;
+}
+
+// SSE2 has no 32-bit min or max: pick with a mask instead
+inline __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline int32_t minValue(const int32_t * p, size_t n)
+{
+   assert(n > 0);
+   if (n < 4)
+      return minValue<int32_t>(p, n);
+   __m128i m = _mm_loadu_si128((const __m128i *)p);
+   size_t i = 4;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+      m = select(_mm_cmplt_epi32(v, m), v, m);
+   }
+   int32_t lanes[4];
+   _mm_storeu_si128((__m128i *)lanes, m);
+   int32_t result = minValue<int32_t>(lanes, 4);
+   return i < n ? (std::min)(result, minValue<int32_t>(p + i, n - i)) : result;
+}
+
+inline int32_t maxValue(const int32_t * p, size_t n)
+{
+   assert(n > 0);
+   if (n < 4)
+      return maxValue<int32_t>(p, n);
+   __m128i m = _mm_loadu_si128((const __m128i *)p);
+   size_t i = 4;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+      m = select(_mm_cmpgt_epi32(v, m), v, m);
+   }
+   int32_t lanes[4];
+   _mm_storeu_si128((__m128i *)lanes, m);
+   int32_t result = maxValue<int32_t>(lanes, 4);
+   return i < n ? (std::max)(result, maxValue<int32_t>(p + i, n - i)) : result;
+}
+
+inline int32_t sum(const int32_t * p, size_t n)
+{
+   __m128i s = _mm_setzero_si128();
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+      s = _mm_add_epi32(s, _mm_loadu_si128((const __m128i *)(p + i)));
+   int32_t lanes[4];
+   _mm_storeu_si128((__m128i *)lanes, s);
+   // add as unsigned: int32 sums wrap just like the SIMD lanes do
+   uint32_t result = (uint32_t)lanes[0] + (uint32_t)lanes[1] +
+                     (uint32_t)lanes[2] + (uint32_t)lanes[3];
+   for (; i < n; i++)
+      result += (uint32_t)p[i];
+   return (int32_t)result;
+}
+
+/*****************************************
+ * SSE2 KERNELS :: FLOAT
+ ****************************************/
+inline const float * find(const float * p, size_t n, const float & x)
+{
+   __m128 key = _mm_set1_ps(x);
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+      if (_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p + i), key)))
+         break;
+   for (; i < n; i++)
+      if (p[i] == x)
+         return p + i;
+   return p + n;
+}
+
+inline size_t count(const float * p, size_t n, const float & x)
+{
+   __m128 key = _mm_set1_ps(x);
+   size_t num = 0;
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+      num += bitsInMask(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p + i), key)));
+   for (; i < n; i++)
+      num += (p[i] == x);
+   return num;
+}
+
+inline float minValue(const float * p, size_t n)
+{
+   assert(n > 0);
+   if (n < 4)
+      return minValue<float>(p, n);
+   __m128 m = _mm_loadu_ps(p);
+   size_t i = 4;
+   for (; i + 4 <= n; i += 4)
+      m = _mm_min_ps(m, _mm_loadu_ps(p + i));
+   float lanes[4];
+   _mm_storeu_ps(lanes, m);
+   float result = minValue<float>(lanes, 4);
+   return i < n ? (std::min)(result, minValue<float>(p + i, n - i)) : result;
+}
+
+inline float maxValue(const float * p, size_t n)
+{
+   assert(n > 0);
+   if (n < 4)
+      return maxValue<float>(p, n);
+   __m128 m = _mm_loadu_ps(p);
+   size_t i = 4;
+   for (; i + 4 <= n; i += 4)
+      m = _mm_max_ps(m, _mm_loadu_ps(p + i));
+   float lanes[4];
+   _mm_storeu_ps(lanes, m);
+   float result = maxValue<float>(lanes, 4);
+   return i < n ? (std::max)(result, maxValue<float>(p + i, n - i)) : result;
+}
+
+inline float sum(const float * p, size_t n)
+{
+   __m128 s0 = _mm_setzero_ps();
+   __m128 s1 = _mm_setzero_ps();
+   size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      s0 = _mm_add_ps(s0, _mm_loadu_ps(p + i));
+      s1 = _mm_add_ps(s1, _mm_loadu_ps(p + i + 4));
+   }
+   float lanes[4];
+   _mm_storeu_ps(lanes, _mm_add_ps(s0, s1));
+   float result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+   for (; i < n; i++)
+      result += p[i];
+   return result;
+}
+
+inline float dot(const float * p, const float * q, size_t n)
+{
+   __m128 s0 = _mm_setzero_ps();
+   __m128 s1 = _mm_setzero_ps();
+   size_t i = 0;
+   for (; i + 8 <= n; i += 8)
+   {
+      s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(p + i),     _mm_loadu_ps(q + i)));
+      s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(p + i + 4), _mm_loadu_ps(q + i + 4)));
+   }
+   float lanes[4];
+   _mm_storeu_ps(lanes, _mm_add_ps(s0, s1));
+   float result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+   for (; i < n; i++)
+      result += p[i] * q[i];
+   return result;
+}
+
+/*****************************************
+ * SSE2 KERNELS :: DOUBLE
+ ****************************************/
+inline const double * find(const double * p, size_t n, const double & x)
+{
+   __m128d key = _mm_set1_pd(x);
+   size_t i = 0;
+   for (; i + 2 <= n; i += 2)
+      if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i), key)))
+         break;
+   for (; i < n; i++)
+      if (p[i] == x)
+         return p + i;
+   return p + n;
+}
+
+inline size_t count(const double * p, size_t n, const double & x)
+{
+   __m128d key = _mm_set1_pd(x);
+   size_t num = 0;
+   size_t i = 0;
+   for (; i + 2 <= n; i += 2)
+      num += bitsInMask(_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i), key)));
+   for (; i < n; i++)
+      num += (p[i] == x);
+   return num;
+}
+
+inline double minValue(const double * p, size_t n)
+{
+   assert(n > 0);
+   if (n < 2)
+      return p[0];
+   __m128d m = _mm_loadu_pd(p);
+   size_t i = 2;
+   for (; i + 2 <= n; i += 2)
+      m = _mm_min_pd(m, _mm_loadu_pd(p + i));
+   double lanes[2];
+   _mm_storeu_pd(lanes, m);
+   double result = lanes[1] < lanes[0] ? lanes[1] : lanes[0];
+   return i < n && p[i] < result ? p[i] : result;
+}
+
+inline double maxValue(const double * p, size_t n)
+{
+   assert(n > 0);
+   if (n < 2)
+      return p[0];
+   __m128d m = _mm_loadu_pd(p);
+   size_t i = 2;
+   for (; i + 2 <= n; i += 2)
+      m = _mm_max_pd(m, _mm_loadu_pd(p + i));
+   double lanes[2];
+   _mm_storeu_pd(lanes, m);
+   double result = lanes[0] < lanes[1] ? lanes[1] : lanes[0];
+   return i < n && result < p[i] ? p[i] : result;
+}
+
+inline double sum(const double * p, size_t n)
+{
+   __m128d s0 = _mm_setzero_pd();
+   __m128d s1 = _mm_setzero_pd();
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      s0 = _mm_add_pd(s0, _mm_loadu_pd(p + i));
+      s1 = _mm_add_pd(s1, _mm_loadu_pd(p + i + 2));
+   }
+   double lanes[2];
+   _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+   double result = lanes[0] + lanes[1];
+   for (; i < n; i++)
+      result += p[i];
+   return result;
+}
+
+inline double dot(const double * p, const double * q, size_t n)
+{
+   __m128d s0 = _mm_setzero_pd();
+   __m128d s1 = _mm_setzero_pd();
+   size_t i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(p + i),     _mm_loadu_pd(q + i)));
+      s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(p + i + 2), _mm_loadu_pd(q + i + 2)));
+   }
+   double lanes[2];
+   _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+   double result = lanes[0] + lanes[1];
+   for (; i < n; i++)
+      result += p[i] * q[i];
+   return result;
+}
+
+#endif // CUSTOM_SIMD_SSE2
+
+} // namespace simd
+
+/*****************************************
+ * VECTOR :: FIND
+ * The first element equal to x, or end()
+ ****************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: const_iterator find(const vector <T, A, G> & v, const T & x)
+{
+   if (v.empty())
+      return v.end();
+   const T * p = &v[0];
+   return v.begin() + (simd::find(p, v.size(), x) - p);
+}
+
+/*****************************************
+ * VECTOR :: COUNT
+ * How many elements equal x
+ ****************************************/
+template <typename T, typename A, typename G>
+size_t count(const vector <T, A, G> & v, const T & x)
+{
+   return v.empty() ? 0 : simd::count(&v[0], v.size(), x);
+}
+
+/*****************************************
+ * VECTOR :: MIN ELEMENT and MAX ELEMENT
+ * The first smallest (largest) element, or end()
+ * if v is empty.  One pass finds the value, a
+ * second finds where it is; both are vectorized
+ ****************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: const_iterator min_element(const vector <T, A, G> & v)
+{
+   if (v.empty())
+      return v.end();
+   return find(v, simd::minValue(&v[0], v.size()));
+}
+
+template <typename T, typename A, typename G>
+typename vector <T, A, G> :: const_iterator max_element(const vector <T, A, G> & v)
+{
+   if (v.empty())
+      return v.end();
+   return find(v, simd::maxValue(&v[0], v.size()));
+}
+
+/*****************************************
+ * VECTOR :: SUM
+ * All the elements added up, T() if v is empty
+ ****************************************/
+template <typename T, typename A, typename G>
+T sum(const vector <T, A, G> & v)
+{
+   return v.empty() ? T() : simd::sum(&v[0], v.size());
+}
+
+/*****************************************
+ * VECTOR :: DOT
+ * The sum of the products of matching elements
+ *     INPUT  : v and w the same size
+ ****************************************/
+template <typename T, typename A, typename G>
+T dot(const vector <T, A, G> & v, const vector <T, A, G> & w)
+{
+   assert(v.size() == w.size());
+   return v.empty() ? T() : simd::dot(&v[0], &w[0], v.size());
+}
+
+} // namespace custom
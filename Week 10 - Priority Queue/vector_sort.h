@@ -0,0 +1,416 @@
+/***********************************************************************
+ * Header:
+ *    VECTOR SORT
+ * Summary:
+ *    Sorting for custom::vector, in place, with no trip through
+ *    std::vector:
+ *
+ *       custom::sort(v)               ascending; radix sort for numbers
+ *       custom::sort(v, less)         any comparison
+ *       custom::sort_by_key(v, key)   radix sort on key(element), where
+ *                                     the key is an integer or float
+ *
+ *    The radix sort is LSD, one byte per pass, so a vector of uint32_t
+ *    takes four passes over the data whatever its order.  Passes on a
+ *    byte that every key shares are skipped.  It is stable.  Elements
+ *    memcpy cannot copy are sorted by (key, index) and then moved into
+ *    place once each.
+ *
+ *    Big vectors (a few hundred thousand elements and up) are cut into
+ *    one chunk per hardware thread; each thread sorts its chunk and the
+ *    sorted chunks are then merged in pairs, also in parallel.
+ *
+ *    Floating-point keys sort with -0.0 before 0.0 and NaNs at the two
+ *    ends (by sign), which is not what < would say about them.
+ *
+ *    This will contain:
+ *        sorting::*             : The kernels, over a pointer and a count
+ *        sort, sort_by_key      : The same, over a custom::vector
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>    // because I am paranoid
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t
+#include <cstring>    // for std::memcpy
+#include <exception>  // for std::exception_ptr
+#include <algorithm>  // for std::sort and std::inplace_merge
+#include <functional> // for std::less
+#include <memory>     // for std::allocator
+#include <new>        // for placement new
+#include <thread>     // for std::thread
+#include <type_traits>
+#include <utility>    // for std::declval
+#include "vector.h"
+#include "bit_vector.h"
+
+namespace custom
+{
+namespace sorting
+{
+
+/*****************************************
+ * RADIX KEY
+ * Maps a key onto an unsigned integer of the same
+ * size whose order is the key's order: signed
+ * integers flip the sign bit, floats flip the sign
+ * bit of positives and every bit of negatives
+ ****************************************/
+template <class K, class Enable = void>
+struct radix_key;
+
+template <class K>
+struct radix_key <K, typename std::enable_if<std::is_integral<K>::value &&
+                                             std::is_unsigned<K>::value>::type>
+{
+   typedef K type;
+   static type map(K k) { return k; }
+};
+
+template <class K>
+struct radix_key <K, typename std::enable_if<std::is_integral<K>::value &&
+                                             std::is_signed<K>::value>::type>
+{
+   typedef typename std::make_unsigned<K>::type type;
+   static type map(K k) { return type(type(k) ^ (type(1) << (sizeof(K) * 8 - 1))); }
+};
+
+template <>
+struct radix_key <float>
+{
+   typedef uint32_t type;
+   static type map(float k)
+   {
+      uint32_t u;
+      std::memcpy(&u, &k, sizeof(u));
+      return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+   }
+};
+
+template <>
+struct radix_key <double>
+{
+   typedef uint64_t type;
+   static type map(double k)
+   {
+      uint64_t u;
+      std::memcpy(&u, &k, sizeof(u));
+      return (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+   }
+};
+
+/*****************************************
+ * HAS RADIX KEY
+ * Whether radix_key<K> is defined, so sort() can
+ * send long double and friends to std::less instead
+ ****************************************/
+template <class K, class Enable = void>
+struct has_radix_key : std::false_type { };
+
+template <class K>
+struct has_radix_key <K, decltype((void)radix_key<K>::map(std::declval<K>()))> : std::true_type { };
+
+// the key that sorting by value uses
+struct identity
+{
+   template <class T>
+   const T & operator () (const T & t) const { return t; }
+};
+
+// the mapped key of t, as radix sort sees it
+template <class T, class KeyOf>
+auto mappedKey(const T & t, const KeyOf & key)
+   -> typename radix_key<typename std::decay<decltype(key(t))>::type>::type
+{
+   return radix_key<typename std::decay<decltype(key(t))>::type>::map(key(t));
+}
+
+/***************************************
+ * RADIX SORT
+ * Stable LSD radix sort of p[0, n) on key(p[i]).
+ * Elements memcpy can copy are sorted directly;
+ * anything else sorts (key, index) pairs and then
+ * moves each element once into its place
+ *     INPUT  : p, n   the elements
+ *              key    element -> integer or float
+ **************************************/
+template <class T, class KeyOf>
+void radix_sort(T * p, size_t n, const KeyOf & key, std::true_type)
+{
+   typedef decltype(mappedKey(*p, key)) U;
+   const size_t numDigits = sizeof(U);
+   if (n < 2)
+      return;
+
+   // one pass builds every byte's histogram
+   size_t counts[numDigits][256] = {};
+   for (size_t i = 0; i < n; i++)
+   {
+      U u = mappedKey(p[i], key);
+      for (size_t d = 0; d < numDigits; d++)
+         counts[d][(u >> (8 * d)) & 0xff]++;
+   }
+
+   // each byte scatters the elements into scratch and back
+   std::allocator<T> alloc;
+   T * scratch = alloc.allocate(n);
+   T * src = p;
+   T * dest = scratch;
+   for (size_t d = 0; d < numDigits; d++)
+   {
+      size_t * count = counts[d];
+
+      // every key has the same byte here: the pass would change nothing
+      if (count[(mappedKey(src[0], key) >> (8 * d)) & 0xff] == n)
+         continue;
+
+      size_t start = 0;
+      for (size_t b = 0; b < 256; b++)
+      {
+         size_t num = count[b];
+         count[b] = start;
+         start += num;
+      }
+      for (size_t i = 0; i < n; i++)
+      {
+         size_t b = (mappedKey(src[i], key) >> (8 * d)) & 0xff;
+         std::memcpy((void *)(dest + count[b]++), (const void *)(src + i), sizeof(T));
+      }
+      std::swap(src, dest);
+   }
+
+   if (src != p)
+      std::memcpy((void *)p, (const void *)src, n * sizeof(T));
+   alloc.deallocate(scratch, n);
+}
+
+template <class T, class KeyOf>
+void radix_sort(T * p, size_t n, const KeyOf & key, std::false_type)
+{
+   typedef decltype(mappedKey(*p, key)) U;
+   struct keyed
+   {
+      U key;
+      size_t index;
+   };
+   if (n < 2)
+      return;
+
+   vector <keyed> order;
+   order.reserve(n);
+   for (size_t i = 0; i < n; i++)
+      order.push_back(keyed{ mappedKey(p[i], key), i });
+   radix_sort(&order[0], n, [](const keyed & k) { return k.key; }, std::true_type());
+
+   // move each element to its place in a fresh buffer, then back
+   std::allocator<T> alloc;
+   T * sorted = alloc.allocate(n);
+   size_t i = 0;
+   try
+   {
+      for (; i < n; i++)
+         new ((void *)(sorted + i)) T(std::move(p[order[i].index]));
+   }
+   catch (...)
+   {
+      while (i > 0)
+         sorted[--i].~T();
+      alloc.deallocate(sorted, n);
+      throw;
+   }
+   for (i = 0; i < n; i++)
+   {
+      p[i] = std::move(sorted[i]);
+      sorted[i].~T();
+   }
+   alloc.deallocate(sorted, n);
+}
+
+template <class T, class KeyOf>
+void radix_sort(T * p, size_t n, const KeyOf & key)
+{
+   radix_sort(p, n, key, std::is_trivially_copyable<T>());
+}
+
+/***************************************
+ * NUM CHUNKS
+ * How many threads a sort of n elements is worth:
+ * at most one per hardware thread, and no chunk
+ * smaller than minChunk
+ **************************************/
+const size_t minChunk = 1 << 16;
+
+inline size_t numChunks(size_t n)
+{
+   size_t numThreads = std::thread::hardware_concurrency();
+   size_t num = n / minChunk;
+   if (numThreads == 0)
+      numThreads = 1;
+   return num < numThreads ? num : numThreads;
+}
+
+/***************************************
+ * RUN ALL
+ * Call task(i) for i in [0, num), each on its own
+ * thread but the first, which runs here.  If a
+ * thread cannot be started, the ones that were are
+ * joined before the error is passed on.  A task
+ * that throws has its exception caught where it
+ * ran; once every thread is joined, the first one
+ * (by i) is thrown again here
+ **************************************/
+template <class Task>
+void runAll(size_t num, Task task)
+{
+   vector <std::exception_ptr> errors(num);
+   auto guarded = [&task, &errors](size_t i)
+   {
+      try
+      {
+         task(i);
+      }
+      catch (...)
+      {
+         errors[i] = std::current_exception();
+      }
+   };
+
+   vector <std::thread> threads;
+   threads.reserve(num);
+   try
+   {
+      for (size_t i = 1; i < num; i++)
+         threads.push_back(std::thread(guarded, i));
+   }
+   catch (...)
+   {
+      for (size_t i = 0; i < threads.size(); i++)
+         threads[i].join();
+      throw;
+   }
+   if (num > 0)
+      guarded(0);
+   for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+
+   for (size_t i = 0; i < num; i++)
+      if (errors[i])
+         std::rethrow_exception(errors[i]);
+}
+
+/***************************************
+ * PARALLEL SORT
+ * Cut p[0, n) into num chunks, sort each on its
+ * own thread with sortChunk, then merge neighbours
+ * in rounds, every merge of a round on its own
+ * thread.  Stable if sortChunk is.  If sortChunk
+ * or less throws, the exception reaches the caller
+ * and p holds its elements in no particular order
+ *     INPUT  : p, n       the elements
+ *              num        how many chunks
+ *              sortChunk  (T *, size_t) sorts one chunk
+ *              less       the order sortChunk sorts by
+ **************************************/
+template <class T, class ChunkSort, class Less>
+void parallel_sort(T * p, size_t n, size_t num, ChunkSort sortChunk, Less less)
+{
+   if (num < 2 || n < num)
+   {
+      sortChunk(p, n);
+      return;
+   }
+
+   vector <size_t> bounds(num + 1);
+   for (size_t c = 0; c <= num; c++)
+      bounds[c] = n / num * c + (n % num) * c / num;
+
+   runAll(num, [&](size_t c)
+   {
+      sortChunk(p + bounds[c], bounds[c + 1] - bounds[c]);
+   });
+
+   for (size_t width = 1; width < num; width *= 2)
+   {
+      size_t numMerges = (num + 2 * width - 1) / (2 * width);
+      runAll(numMerges, [&](size_t m)
+      {
+         size_t c = m * 2 * width;
+         if (c + width >= num)
+            return;                             // an odd run out: already sorted
+         size_t last = c + 2 * width < num ? c + 2 * width : num;
+         std::inplace_merge(p + bounds[c], p + bounds[c + width], p + bounds[last], less);
+      });
+   }
+}
+
+} // namespace sorting
+
+/***************************************
+ * SORT BY KEY
+ * Stable radix sort on key(element), threaded when
+ * the vector is big
+ *     INPUT  : v    the vector to sort
+ *              key  element -> integer or float
+ **************************************/
+template <typename T, typename A, typename G, class KeyOf>
+void sort_by_key(vector <T, A, G> & v, KeyOf key)
+{
+   if (v.size() < 2)
+      return;
+   sorting::parallel_sort(&v[0], v.size(), sorting::numChunks(v.size()),
+      [key](T * p, size_t n) { sorting::radix_sort(p, n, key); },
+      [key](const T & lhs, const T & rhs)
+      {
+         return sorting::mappedKey(lhs, key) < sorting::mappedKey(rhs, key);
+      });
+}
+
+/***************************************
+ * SORT
+ * With a comparison: std::sort on each chunk, then
+ * the parallel merge
+ *     INPUT  : v     the vector to sort
+ *              less  strict weak order
+ **************************************/
+template <typename T, typename A, typename G, class Less>
+void sort(vector <T, A, G> & v, Less less)
+{
+   if (v.size() < 2)
+      return;
+   sorting::parallel_sort(&v[0], v.size(), sorting::numChunks(v.size()),
+      [less](T * p, size_t n) { std::sort(p, p + n, less); },
+      less);
+}
+
+/***************************************
+ * SORT
+ * Ascending: numbers with a radix key go to the
+ * radix sort, anything else is compared with <
+ **************************************/
+namespace sorting
+{
+template <typename T, typename A, typename G>
+void ascending(vector <T, A, G> & v, std::true_type)  { sort_by_key(v, identity()); }
+template <typename T, typename A, typename G>
+void ascending(vector <T, A, G> & v, std::false_type) { sort(v, std::less<T>()); }
+} // namespace sorting
+
+template <typename T, typename A, typename G>
+void sort(vector <T, A, G> & v)
+{
+   sorting::ascending(v, typename sorting::has_radix_key<T>::type());
+}
+
+// flags sort by counting: the falses, then the trues
+template <typename A, typename G>
+void sort(bit_vector <A, G> & v)
+{
+   size_t num = v.size();
+   size_t numTrue = v.count();
+   v.clear();
+   v.resize(num - numTrue, false);
+   v.resize(num, true);
+}
+
+} // namespace custom
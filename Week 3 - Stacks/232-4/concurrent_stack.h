@@ -0,0 +1,364 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT STACK
+ * Summary:
+ *    A LIFO that many threads can push onto and pop from at once
+ *    without a lock (a Treiber stack):
+ *
+ *       custom::concurrent_stack<Job> work;
+ *       // any thread:
+ *       work.push(job);
+ *       Job job;
+ *       while (work.try_pop(job))
+ *          job.run();
+ *
+ *    The top is one 64-bit word, a node index and a tag, and every
+ *    push or pop is a compare-exchange on it.  The tag goes up by one
+ *    on every exchange, so a thread that read the top, was put to
+ *    sleep while the node was popped and pushed again, and woke up to
+ *    the same index still fails its exchange (the ABA problem).
+ *
+ *    Nodes are never freed while the stack lives.  A popped node goes
+ *    on a free list (a second Treiber stack) to be reused by the next
+ *    push, and the nodes live in the same doubling blocks as
+ *    stable_vector.  So a thread that reads the next link of a node
+ *    someone else just popped reads memory that is still a node, and
+ *    the tag makes its exchange fail.  This costs the high-water mark
+ *    of nodes in memory until the stack is destroyed.
+ *
+ *    push_range links a whole batch into a chain first and then
+ *    publishes it with one exchange, so a batch lands all together,
+ *    last element on top, with no other thread's push in between.
+ *
+ *    This will contain the class definition of:
+ *        concurrent_stack       : A lock-free Treiber stack
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>   // because I am paranoid
+#include <atomic>    // for std::atomic
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint32_t and uint64_t
+#include <memory>    // for std::allocator
+#include <new>       // for placement new
+#include <stdexcept> // for std::length_error
+#include <utility>   // for std::move and std::forward
+#include "stable_vector.h" // for segment
+
+class TestConcurrentStack; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * CONCURRENT STACK
+ * top and freeList each hold (tag << 32) | (index + 1),
+ * where index 0 is the first node ever handed out and
+ * a low half of zero is the empty stack.  numNodes
+ * hands out fresh indices; the block table is installed
+ * the same way concurrent_vector's is.
+ *
+ * T's move assignment should not throw: try_pop has
+ * already taken the node off the stack when it moves
+ * the value out
+ ****************************************/
+template <typename T, typename A = std::allocator<T>>
+class concurrent_stack
+{
+   friend class ::TestConcurrentStack; // give unit tests access to the privates
+public:
+   typedef T value_type;
+   typedef A allocator_type;
+
+   //
+   // Construct
+   //
+
+   concurrent_stack(const A & a = A());
+   concurrent_stack(const concurrent_stack & rhs) = delete;
+   concurrent_stack & operator = (const concurrent_stack & rhs) = delete;
+   ~concurrent_stack();
+
+   //
+   // Insert: safe from any number of threads at once
+   //
+
+   void push(const T & t) { emplace(t);            }
+   void push(T && t)      { emplace(std::move(t)); }
+   template <class ... Args>
+   void emplace(Args && ... args);
+   template <class Iterator>
+   void push_range(Iterator first, Iterator last);
+
+   //
+   // Remove: safe from any number of threads at once
+   //
+
+   bool try_pop(T & t);
+
+   //
+   // Status: a snapshot, which other threads may change at once
+   //
+
+   bool empty() const { return link(top.load(std::memory_order_acquire)) == 0; }
+
+private:
+   struct node
+   {
+      std::atomic<uint32_t> next;                  // link (index + 1) below this one
+      alignas(T) unsigned char value[sizeof(T)];   // live only while on the stack
+      T * get() { return reinterpret_cast<T *>(value); }
+   };
+   typedef typename std::allocator_traits<A>::template rebind_alloc<node> node_allocator;
+   typedef std::allocator_traits<node_allocator> traits;
+
+   // the halves of a top word
+   static uint32_t link(uint64_t word)           { return (uint32_t)word;          }
+   static uint64_t tagged(uint64_t word, uint32_t l)
+   {
+      return ((word >> 32) + 1) << 32 | l;       // one more tag, the new link
+   }
+
+   node * at(uint32_t l) const
+   {
+      assert(l != 0);
+      node * block = blocks[segment::block(l - 1)].load(std::memory_order_acquire);
+      assert(block != nullptr);
+      return block + segment::offset(l - 1);
+   }
+
+   uint32_t acquire();
+   uint32_t claim();
+   void splice(std::atomic<uint64_t> & head, uint32_t first, uint32_t last);
+   uint32_t unlink(std::atomic<uint64_t> & head);
+
+   node_allocator alloc;                            // hands out the blocks
+   std::atomic<node *> blocks[segment::maxBlocks];  // installed once, never moved
+   std::atomic<uint64_t> top;                       // the stack
+   std::atomic<uint64_t> freeList;                  // popped nodes, ready for reuse
+   std::atomic<uint32_t> numNodes;                  // fresh indices handed out so far
+};
+
+/*****************************************
+ * CONCURRENT STACK :: DEFAULT constructor
+ * No blocks until the first push
+ ****************************************/
+template <typename T, typename A>
+concurrent_stack <T, A> :: concurrent_stack(const A & a) :
+   alloc(a), top(0), freeList(0), numNodes(0)
+{
+   for (size_t k = 0; k < segment::maxBlocks; k++)
+      blocks[k].store(nullptr, std::memory_order_relaxed);
+}
+
+/*****************************************
+ * CONCURRENT STACK :: DESTRUCTOR
+ * Not thread-safe: every thread must be done
+ ****************************************/
+template <typename T, typename A>
+concurrent_stack <T, A> :: ~concurrent_stack()
+{
+   for (uint32_t l = link(top.load(std::memory_order_acquire)); l != 0;
+        l = at(l)->next.load(std::memory_order_relaxed))
+      at(l)->get()->~T();
+
+   for (size_t k = 0; k < segment::maxBlocks; k++)
+   {
+      node * block = blocks[k].load(std::memory_order_relaxed);
+      if (block)
+         traits::deallocate(alloc, block, segment::blockSize(k));
+   }
+}
+
+/***************************************
+ * CONCURRENT STACK :: EMPLACE
+ * Build the element in a node of its own, then
+ * swing the top to it
+ *     INPUT  : args for one of T's constructors
+ **************************************/
+template <typename T, typename A>
+template <class ... Args>
+void concurrent_stack <T, A> :: emplace(Args && ... args)
+{
+   uint32_t l = acquire();
+   try
+   {
+      new ((void *)at(l)->value) T(std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      splice(freeList, l, l);
+      throw;
+   }
+   splice(top, l, l);
+}
+
+/***************************************
+ * CONCURRENT STACK :: PUSH RANGE
+ * Build every element into a private chain, each
+ * node linked to the one before, then splice the
+ * chain on with one exchange.  If an element throws,
+ * the ones built are destroyed and nothing is pushed
+ *     INPUT  : [first, last) in push order
+ **************************************/
+template <typename T, typename A>
+template <class Iterator>
+void concurrent_stack <T, A> :: push_range(Iterator first, Iterator last)
+{
+   uint32_t bottom = 0;                         // first pushed, lowest in the chain
+   uint32_t chain = 0;                          // last pushed, top of the chain
+   try
+   {
+      for (; first != last; ++first)
+      {
+         uint32_t l = acquire();
+         try
+         {
+            new ((void *)at(l)->value) T(*first);
+         }
+         catch (...)
+         {
+            splice(freeList, l, l);
+            throw;
+         }
+         at(l)->next.store(chain, std::memory_order_relaxed);
+         if (bottom == 0)
+            bottom = l;
+         chain = l;
+      }
+   }
+   catch (...)
+   {
+      for (uint32_t l = chain; l != 0; l = at(l)->next.load(std::memory_order_relaxed))
+         at(l)->get()->~T();
+      if (chain != 0)
+         splice(freeList, chain, bottom);
+      throw;
+   }
+
+   if (chain != 0)
+      splice(top, chain, bottom);
+}
+
+/***************************************
+ * CONCURRENT STACK :: TRY POP
+ * Take the top element, if there is one
+ *     OUTPUT : t      the element, moved out
+ *              return false if the stack was empty
+ **************************************/
+template <typename T, typename A>
+bool concurrent_stack <T, A> :: try_pop(T & t)
+{
+   uint32_t l = unlink(top);
+   if (l == 0)
+      return false;
+
+   T * p = at(l)->get();
+   try
+   {
+      t = std::move(*p);
+   }
+   catch (...)
+   {
+      p->~T();
+      splice(freeList, l, l);
+      throw;
+   }
+   p->~T();
+   splice(freeList, l, l);
+   return true;
+}
+
+/***************************************
+ * CONCURRENT STACK :: ACQUIRE
+ * A node for the calling thread alone: a recycled
+ * one if there is one, otherwise a fresh one
+ *     OUTPUT : its link
+ **************************************/
+template <typename T, typename A>
+uint32_t concurrent_stack <T, A> :: acquire()
+{
+   uint32_t l = unlink(freeList);
+   return l != 0 ? l : claim();
+}
+
+/***************************************
+ * CONCURRENT STACK :: CLAIM
+ * A node that has never been used, allocating its
+ * block if nobody has yet.  Racing threads each
+ * allocate; one compare-exchange wins
+ *     OUTPUT : its link
+ **************************************/
+template <typename T, typename A>
+uint32_t concurrent_stack <T, A> :: claim()
+{
+   uint32_t index = numNodes.fetch_add(1, std::memory_order_relaxed);
+   if (index == UINT32_MAX)
+   {
+      numNodes.fetch_sub(1, std::memory_order_relaxed);
+      throw std::length_error("concurrent_stack: out of node indices");
+   }
+
+   size_t k = segment::block(index);
+   node * block = blocks[k].load(std::memory_order_acquire);
+   if (block == nullptr)
+   {
+      node * fresh = traits::allocate(alloc, segment::blockSize(k));
+      for (size_t i = 0; i < segment::blockSize(k); i++)
+         new ((void *)(fresh + i)) node();
+      if (blocks[k].compare_exchange_strong(block, fresh,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+         block = fresh;
+      else
+         traits::deallocate(alloc, fresh, segment::blockSize(k));
+   }
+   return index + 1;
+}
+
+/***************************************
+ * CONCURRENT STACK :: SPLICE
+ * Push the chain first ... last, already linked
+ * from first down to last, onto head
+ *     INPUT  : head   top or freeList
+ *              first  the new top
+ *              last   the bottom of the chain
+ **************************************/
+template <typename T, typename A>
+void concurrent_stack <T, A> :: splice(std::atomic<uint64_t> & head,
+                                       uint32_t first, uint32_t last)
+{
+   node * pLast = at(last);
+   uint64_t word = head.load(std::memory_order_relaxed);
+   do
+      pLast->next.store(link(word), std::memory_order_relaxed);
+   while (!head.compare_exchange_weak(word, tagged(word, first),
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed));
+}
+
+/***************************************
+ * CONCURRENT STACK :: UNLINK
+ * Pop one node off head.  The next link read may
+ * belong to a node another thread has since popped
+ * and reused; the tag then fails the exchange
+ *     INPUT  : head   top or freeList
+ *     OUTPUT : its link, or 0 if head was empty
+ **************************************/
+template <typename T, typename A>
+uint32_t concurrent_stack <T, A> :: unlink(std::atomic<uint64_t> & head)
+{
+   uint64_t word = head.load(std::memory_order_acquire);
+   while (link(word) != 0)
+   {
+      uint32_t below = at(link(word))->next.load(std::memory_order_relaxed);
+      if (head.compare_exchange_weak(word, tagged(word, below),
+                                     std::memory_order_acquire,
+                                     std::memory_order_acquire))
+         return link(word);
+   }
+   return 0;
+}
+
+} // namespace custom
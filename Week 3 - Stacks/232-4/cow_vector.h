@@ -0,0 +1,177 @@
+/***********************************************************************
+ * Header:
+ *    COW VECTOR
+ * Summary:
+ *    A copy-on-write vector.  Copying one just shares the buffer and
+ *    bumps a reference count, so a snapshot is O(1) no matter how big
+ *    the vector is.  The first change made through a copy that is
+ *    still shared clones the buffer ("detaches") and changes the clone.
+ *
+ *       custom::cow_vector<Record> live = ...;
+ *       custom::cow_vector<Record> snapshot = live;   // no copies
+ *       live.push_back(r);                            // live detaches
+ *
+ *    Anything that could change an element detaches: non-const
+ *    operator[], front(), back(), begin() and end() included.  Read
+ *    through a const reference (or cbegin/cend) to avoid it.  A
+ *    reference or iterator from a shared copy may be left pointing at
+ *    the old buffer after a detach.
+ *
+ *    The reverse hazard: a T& or iterator taken while the buffer is
+ *    unshared still points into it after a later copy starts sharing
+ *    it, so writing through it changes the "snapshot" too.  Nothing
+ *    tracks handed-out references, so take them again after copying.
+ *
+ *    It fits anywhere custom::vector does as a container, e.g.
+ *    custom::stack<T, custom::cow_vector<T>>.
+ *
+ *    This will contain the class definition of:
+ *        cow_vector             : A vector whose copies share until written
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <cstddef>  // for size_t
+#include <memory>   // for std::shared_ptr
+#include <utility>  // for std::move
+#include <initializer_list>
+#include "vector.h"
+
+class TestCowVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * COW VECTOR
+ * buffer is shared by every copy.  It is null while
+ * the vector has never held anything, so an empty
+ * cow_vector allocates nothing at all
+ ****************************************/
+template <typename T, typename A = std::allocator<T>>
+class cow_vector
+{
+   friend class ::TestCowVector; // give unit tests access to the privates
+public:
+   typedef T value_type;
+   typedef A allocator_type;
+   typedef vector <T, A> vector_type;
+   typedef typename vector_type::iterator       iterator;
+   typedef typename vector_type::const_iterator const_iterator;
+
+   //
+   // Construct
+   //
+
+   cow_vector(const A & a = A()) : alloc(a) { }
+   cow_vector(size_t num, const A & a = A()) :
+      buffer(num ? std::allocate_shared<vector_type>(a, num, a) : nullptr), alloc(a) { }
+   cow_vector(size_t num, const T & t, const A & a = A()) :
+      buffer(num ? std::allocate_shared<vector_type>(a, num, t, a) : nullptr), alloc(a) { }
+   cow_vector(const std::initializer_list<T> & l, const A & a = A()) :
+      buffer(l.size() ? std::allocate_shared<vector_type>(a, l, a) : nullptr), alloc(a) { }
+   explicit cow_vector(vector_type && v) :
+      buffer(std::allocate_shared<vector_type>(v.get_allocator(), std::move(v))),
+      alloc(buffer->get_allocator()) { }
+
+   // copies share, moves steal: neither touches an element
+   cow_vector(const cow_vector & rhs)                 = default;
+   cow_vector(cow_vector && rhs) noexcept             = default;
+   cow_vector & operator = (const cow_vector & rhs)     = default;
+   cow_vector & operator = (cow_vector && rhs) noexcept = default;
+
+   void swap(cow_vector & rhs) noexcept
+   {
+      buffer.swap(rhs.buffer);
+      std::swap(alloc, rhs.alloc);
+   }
+
+   //
+   // Read: never detaches
+   //
+
+   const T & operator [] (size_t index) const { return (*buffer)[index]; }
+   const T & front() const { return buffer->front(); }
+   const T & back()  const { return buffer->back();  }
+   const_iterator begin()  const { return buffer ? const_vector().begin() : const_iterator(); }
+   const_iterator end()    const { return buffer ? const_vector().end()   : const_iterator(); }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+
+   size_t size()     const { return buffer ? buffer->size()     : 0; }
+   size_t capacity() const { return buffer ? buffer->capacity() : 0; }
+   bool   empty()    const { return size() == 0; }
+   A get_allocator() const { return alloc; }
+
+   // how many cow_vectors share this buffer (0 if none)
+   long use_count() const { return buffer.use_count(); }
+
+   //
+   // Write: detaches first if the buffer is shared
+   //
+
+   T & operator [] (size_t index) { return write()[index]; }
+   T & front() { return write().front(); }
+   T & back()  { return write().back();  }
+   iterator begin() { return write().begin(); }
+   iterator end()   { return write().end();   }
+
+   void push_back(const T & t) { write().push_back(t);            }
+   void push_back(T && t)      { write().push_back(std::move(t)); }
+   template <class ... Args>
+   T & emplace_back(Args && ... args) { return write().emplace_back(std::forward<Args>(args)...); }
+   void reserve(size_t newCapacity)          { write().reserve(newCapacity); }
+   void resize(size_t newElements)           { write().resize(newElements); }
+   void resize(size_t newElements, const T & t) { write().resize(newElements, t); }
+   void pop_back()      { if (!empty()) write().pop_back(); }
+   void shrink_to_fit() { if (buffer) write().shrink_to_fit(); }
+   void clear();
+
+private:
+   const vector_type & const_vector() const { return *buffer; }
+   vector_type & write();
+
+   std::shared_ptr<vector_type> buffer;  // shared by every copy
+   A alloc;                              // for the buffer when we need one
+};
+
+/***************************************
+ * COW VECTOR :: WRITE
+ * The buffer, all to ourselves.  A shared buffer is
+ * cloned first: the only place elements are copied
+ **************************************/
+template <typename T, typename A>
+typename cow_vector <T, A> :: vector_type & cow_vector <T, A> :: write()
+{
+   if (!buffer)
+      buffer = std::allocate_shared<vector_type>(alloc, alloc);
+   else if (buffer.use_count() > 1)
+      buffer = std::allocate_shared<vector_type>(alloc, *buffer);
+   return *buffer;
+}
+
+/***************************************
+ * COW VECTOR :: CLEAR
+ * A shared buffer is simply let go of: there is no
+ * point copying elements only to destroy them
+ **************************************/
+template <typename T, typename A>
+void cow_vector <T, A> :: clear()
+{
+   if (buffer.use_count() > 1)
+      buffer.reset();
+   else if (buffer)
+      buffer->clear();
+}
+
+/*****************************************
+ * SWAP
+ ****************************************/
+template <typename T, typename A>
+void swap(cow_vector <T, A> & lhs, cow_vector <T, A> & rhs) noexcept
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
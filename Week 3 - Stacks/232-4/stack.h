@@ -14,15 +14,21 @@
  *
  *    This will contain the class definition of:
  *       stack             : similar to std::stack
+ *
+ *    The container is custom::vector unless another is named.  Any
+ *    container with back, push_back, pop_back and size will do, so a
+ *    custom::deque or custom::list works as well as a std:: one.
  * Author
  *    <your names here>
  ************************************************************************/
 
 #pragma once
 
-#include <cassert>  // because I am paranoid
-//#include "vector.h"
-#include <vector>
+#include <cassert>      // because I am paranoid
+#include <memory>       // for std::allocator
+#include <type_traits>
+#include <utility>      // for std::move, std::forward and std::swap
+#include "vector.h"
 #include <iostream>
 
 class TestStack; // forward declaration for unit tests
@@ -30,44 +36,67 @@ class TestStack; // forward declaration for unit tests
 namespace custom
 {
 
+/**************************************************
+ * CONTAINER ALLOCATOR
+ * The container's allocator_type, or std::allocator
+ * for a container that does not name one
+ *************************************************/
+template <class T, class Container, class = void>
+struct container_allocator
+{
+   typedef std::allocator<T> type;
+};
+
+template <class T, class Container>
+struct container_allocator <T, Container,
+   typename std::conditional<true, void, typename Container::allocator_type>::type>
+{
+   typedef typename Container::allocator_type type;
+};
+
 /**************************************************
  * STACK
- * First-in-Last-out data structure
+ * First-in-Last-out data structure.  The elements
+ * live in Container, which also supplies the allocator
  *************************************************/
-template<class T>
+template<class T, class Container = custom::vector<T>>
 class stack
 {
    friend class ::TestStack; // give unit tests access to the privates
 public:
+
+   typedef Container container_type;
+   typedef typename container_allocator<T, Container>::type allocator_type;
   
    //
    // Construct
    //
 
    stack()                            {}
-    stack(const stack <T> &  rhs)      { container = rhs.container; }
-    stack(      stack <T> && rhs)      { container = std::move(rhs.container); }
-   stack(const std::vector<T> &  rhs) { container.resize(7); }
-   stack(      std::vector<T> && rhs) { container.resize(7); }
+   explicit stack(const allocator_type & a) : container(a) {}
+   stack(const stack &  rhs) : container(rhs.container)            {}
+   stack(      stack && rhs) : container(std::move(rhs.container)) {}
+   explicit stack(const Container &  rhs) : container(rhs)            {}
+   explicit stack(      Container && rhs) : container(std::move(rhs)) {}
    ~stack()                           {                      }
 
    //
    // Assign
    //
 
-   stack <T> & operator = (const stack <T> & rhs)
+   stack & operator = (const stack & rhs)
    {
        container = rhs.container;
        return *this;
    }
-   stack <T>& operator = (stack <T> && rhs)
+   stack & operator = (stack && rhs)
    {
        container = std::move(rhs.container);
        return *this;
    }
-   void swap(stack <T>& rhs)
+   void swap(stack & rhs)
    {
-       container.swap(rhs.container);
+       swapContainers(container, rhs.container, 0);
    }
 
    //
@@ -76,7 +105,7 @@ public:
 
     T& top()
     {
-        if (empty()) {
+        if (!empty()) {
             return container.back();
         }
         else {
@@ -95,6 +124,10 @@ public:
    void push(      T&& t) {
        container.push_back(std::move(t));
    }
+   template <class ... Args>
+   void emplace(Args&& ... args) {
+       emplaceBack(container, 0, std::forward<Args>(args)...);
+   }
 
    //
    // Remove
@@ -117,8 +150,34 @@ public:
    bool empty   () const { return size() == 0; }
    
 private:
-   
-  std::vector<T> container;  // underlying container
+
+   // build in place if the container can, otherwise build here and move
+   template <class C, class ... Args>
+   static auto emplaceBack(C & c, int, Args&& ... args)
+      -> decltype(c.emplace_back(std::forward<Args>(args)...), void())
+   {
+       c.emplace_back(std::forward<Args>(args)...);
+   }
+   template <class C, class ... Args>
+   static void emplaceBack(C & c, long, Args&& ... args)
+   {
+       c.push_back(T(std::forward<Args>(args)...));
+   }
+
+   // the container's own swap if it has one, otherwise std::swap
+   template <class C>
+   static auto swapContainers(C & lhs, C & rhs, int)
+      -> decltype(lhs.swap(rhs), void())
+   {
+       lhs.swap(rhs);
+   }
+   template <class C>
+   static void swapContainers(C & lhs, C & rhs, long)
+   {
+       std::swap(lhs, rhs);
+   }
+
+  Container container;  // underlying container
 };
 
 
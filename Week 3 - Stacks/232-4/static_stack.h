@@ -0,0 +1,252 @@
+/***********************************************************************
+ * Header:
+ *    STATIC STACK
+ * Summary:
+ *    A stack of at most N elements kept inside the object itself, so
+ *    a stack on the call stack never touches the heap:
+ *
+ *       custom::static_stack<Token, 64> s;
+ *       if (!s.try_push(token))
+ *          return error("nested too deep");
+ *
+ *    It has the same push/pop/top/size interface as custom::stack.
+ *    push throws std::length_error when all N slots are taken;
+ *    try_push returns false instead, for callers that would rather
+ *    not pay for an exception on a hot path.
+ *
+ *    This will contain the class definition of:
+ *        static_stack           : A fixed-capacity stack with inline storage
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <cstddef>     // for size_t
+#include <new>         // for placement new
+#include <stdexcept>   // for std::length_error and std::out_of_range
+#include <type_traits> // for std::is_nothrow_move_constructible
+#include <utility>     // for std::move and std::forward
+
+class TestStaticStack; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * STATIC STACK
+ * Slots [0, numElements) of buffer hold live
+ * elements; the top is the last of them
+ *************************************************/
+template <class T, size_t N>
+class static_stack
+{
+   static_assert(N > 0, "static_stack needs at least one slot");
+   friend class ::TestStaticStack; // give unit tests access to the privates
+public:
+
+   typedef T value_type;
+
+   //
+   // Construct
+   //
+
+   static_stack() : numElements(0) {}
+   static_stack(const static_stack &  rhs);
+   static_stack(      static_stack && rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+   ~static_stack() { clear(); }
+
+   //
+   // Assign
+   //
+
+   static_stack & operator = (const static_stack &  rhs);
+   static_stack & operator = (      static_stack && rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+   void swap(static_stack & rhs);
+
+   //
+   // Access
+   //
+
+   T & top()
+   {
+      if (empty())
+         throw std::out_of_range("Stack is empty.");
+      return slot(numElements - 1);
+   }
+   const T & top() const
+   {
+      if (empty())
+         throw std::out_of_range("Stack is empty.");
+      return slot(numElements - 1);
+   }
+
+   //
+   // Insert
+   //
+
+   void push(const T &  t) { emplace(t);            }
+   void push(      T && t) { emplace(std::move(t)); }
+   template <class ... Args>
+   void emplace(Args && ... args)
+   {
+      if (!try_emplace(std::forward<Args>(args)...))
+         throw std::length_error("static_stack is full");
+   }
+
+   bool try_push(const T &  t) { return try_emplace(t);            }
+   bool try_push(      T && t) { return try_emplace(std::move(t)); }
+   template <class ... Args>
+   bool try_emplace(Args && ... args)
+   {
+      if (full())
+         return false;
+      new ((void *)(buffer + numElements * sizeof(T))) T(std::forward<Args>(args)...);
+      numElements++;
+      return true;
+   }
+
+   //
+   // Remove
+   //
+
+   void pop()
+   {
+      if (numElements > 0)
+         slot(--numElements).~T();
+   }
+   void clear()
+   {
+      while (numElements > 0)
+         slot(--numElements).~T();
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()  const { return numElements;      }
+   bool   empty() const { return numElements == 0; }
+   bool   full()  const { return numElements == N; }
+   static constexpr size_t capacity() { return N;  }
+
+private:
+
+   void moveFrom(static_stack & rhs);
+
+         T & slot(size_t i)       { return *reinterpret_cast<      T *>(buffer + i * sizeof(T)); }
+   const T & slot(size_t i) const { return *reinterpret_cast<const T *>(buffer + i * sizeof(T)); }
+
+   alignas(T) unsigned char buffer[N * sizeof(T)]; // the slots
+   size_t numElements;                             // how many slots are in use
+};
+
+/*****************************************
+ * STATIC STACK :: COPY constructor
+ * Copy rhs's elements slot by slot.  If a copy
+ * throws, the ones already built are destroyed
+ ****************************************/
+template <class T, size_t N>
+static_stack <T, N> :: static_stack(const static_stack & rhs) : numElements(0)
+{
+   try
+   {
+      for (size_t i = 0; i < rhs.numElements; i++)
+         push(rhs.slot(i));
+   }
+   catch (...)
+   {
+      clear();
+      throw;
+   }
+}
+
+/*****************************************
+ * STATIC STACK :: MOVE constructor
+ * The elements are inline, so they cannot be
+ * stolen: each is moved, and rhs is left empty.
+ * If a move throws, the ones already built are
+ * destroyed and rhs keeps its elements
+ ****************************************/
+template <class T, size_t N>
+static_stack <T, N> :: static_stack(static_stack && rhs)
+   noexcept(std::is_nothrow_move_constructible<T>::value) : numElements(0)
+{
+   moveFrom(rhs);
+   rhs.clear();
+}
+
+/*****************************************
+ * STATIC STACK :: MOVE FROM
+ * Move each of rhs's elements onto this empty
+ * stack.  Kept out of the move constructor so
+ * that a rethrow never sits in a noexcept body
+ ****************************************/
+template <class T, size_t N>
+void static_stack <T, N> :: moveFrom(static_stack & rhs)
+{
+   try
+   {
+      for (size_t i = 0; i < rhs.numElements; i++)
+         push(std::move(rhs.slot(i)));
+   }
+   catch (...)
+   {
+      clear();
+      throw;
+   }
+}
+
+/*****************************************
+ * STATIC STACK :: ASSIGN
+ * Assign over the slots both have, then build
+ * or destroy the difference
+ ****************************************/
+template <class T, size_t N>
+static_stack <T, N> & static_stack <T, N> :: operator = (const static_stack & rhs)
+{
+   if (this == &rhs)
+      return *this;
+   size_t common = numElements < rhs.numElements ? numElements : rhs.numElements;
+   for (size_t i = 0; i < common; i++)
+      slot(i) = rhs.slot(i);
+   while (numElements > rhs.numElements)
+      pop();
+   for (size_t i = numElements; i < rhs.numElements; i++)
+      push(rhs.slot(i));
+   return *this;
+}
+
+template <class T, size_t N>
+static_stack <T, N> & static_stack <T, N> :: operator = (static_stack && rhs)
+   noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+   if (this == &rhs)
+      return *this;
+   clear();
+   for (size_t i = 0; i < rhs.numElements; i++)
+      push(std::move(rhs.slot(i)));
+   rhs.clear();
+   return *this;
+}
+
+/*****************************************
+ * STATIC STACK :: SWAP
+ * Swap the slots both have, then move the rest
+ * of the longer stack across
+ ****************************************/
+template <class T, size_t N>
+void static_stack <T, N> :: swap(static_stack & rhs)
+{
+   using std::swap;
+   static_stack & longer  = numElements >= rhs.numElements ? *this : rhs;
+   static_stack & shorter = numElements >= rhs.numElements ? rhs : *this;
+   size_t common = shorter.numElements;
+   for (size_t i = 0; i < common; i++)
+      swap(slot(i), rhs.slot(i));
+   for (size_t i = common; i < longer.numElements; i++)
+      shorter.push(std::move(longer.slot(i)));
+   while (longer.numElements > common)
+      longer.pop();
+}
+
+} // namespace custom
@@ -0,0 +1,272 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT STACK
+ * Summary:
+ *    Unit tests for concurrent_stack
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_stack.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class TestConcurrentStack : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_destroysAll();
+
+      // Insert and remove, one thread
+      test_push_popLifo();
+      test_tryPop_empty();
+      test_tryPop_reusesNode();
+      test_tag_countsExchanges();
+      test_pushRange_oneExchange();
+      test_emplace_throwRecyclesNode();
+
+      // Many threads
+      test_threads_pushPop();
+      test_threads_pushRangeTogether();
+
+      report("ConcurrentStack");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no blocks
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::concurrent_stack<int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.top.load() == 0);
+      assertUnit(s.numNodes.load() == 0);
+      assertUnit(s.blocks[0].load() == nullptr);
+   }  // teardown
+
+   // whatever is left on the stack is destroyed with it
+   void test_destructor_destroysAll()
+   {  // setup
+      {
+         custom::concurrent_stack<Spy> s;
+         s.push(Spy(26));
+         s.push(Spy(49));
+         s.push(Spy(67));
+         Spy t;
+         s.try_pop(t);
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 3);     // [26,49] and t
+      assertUnit(Spy::numDelete() == 3);
+   }
+
+   /***************************************
+    * INSERT AND REMOVE
+    ***************************************/
+
+   // last in, first out
+   void test_push_popLifo()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      int t = 0;
+      // exercise
+      s.push(26);
+      s.push(49);
+      s.emplace(67);
+      // verify
+      assertUnit(s.try_pop(t) && t == 67);
+      assertUnit(s.try_pop(t) && t == 49);
+      assertUnit(s.try_pop(t) && t == 26);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // nothing to pop leaves t alone
+   void test_tryPop_empty()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      int t = 99;
+      // exercise
+      bool popped = s.try_pop(t);
+      // verify
+      assertUnit(!popped);
+      assertUnit(t == 99);
+   }  // teardown
+
+   // a popped node is the next one pushed into
+   void test_tryPop_reusesNode()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      int t = 0;
+      for (int i = 0; i < 100; i++)
+         s.push(i);
+      while (s.try_pop(t))
+         ;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         s.push(i);
+      // verify
+      assertUnit(s.numNodes.load() == 100);
+      assertUnit(s.try_pop(t) && t == 99);
+   }  // teardown
+
+   // push then pop leaves the same empty top with a tag two higher
+   void test_tag_countsExchanges()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      int t = 0;
+      // exercise
+      s.push(26);
+      uint64_t afterPush = s.top.load();
+      s.try_pop(t);
+      // verify
+      assertUnit(afterPush == ((uint64_t(1) << 32) | 1));
+      assertUnit(s.top.load() == (uint64_t(2) << 32));
+   }  // teardown
+
+   // a batch of five goes on with one exchange, last element on top
+   void test_pushRange_oneExchange()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      s.push(11);
+      int values[] = {26, 49, 67, 89, 99};
+      int t = 0;
+      // exercise
+      s.push_range(values, values + 5);
+      // verify
+      assertUnit((s.top.load() >> 32) == 2);
+      assertUnit(s.try_pop(t) && t == 99);
+      assertUnit(s.try_pop(t) && t == 89);
+      assertUnit(s.try_pop(t) && t == 67);
+      assertUnit(s.try_pop(t) && t == 49);
+      assertUnit(s.try_pop(t) && t == 26);
+      assertUnit(s.try_pop(t) && t == 11);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // a constructor that throws gives its node back and pushes nothing
+   void test_emplace_throwRecyclesNode()
+   {  // setup
+      struct Picky
+      {
+         int value;
+         Picky() : value(0) {}
+         explicit Picky(int v) : value(v) { if (v < 0) throw std::invalid_argument("negative"); }
+      };
+      custom::concurrent_stack<Picky> s;
+      bool threw = false;
+      // exercise
+      try
+      {
+         s.emplace(-1);
+      }
+      catch (const std::invalid_argument &)
+      {
+         threw = true;
+      }
+      s.emplace(26);
+      // verify
+      assertUnit(threw);
+      assertUnit(s.numNodes.load() == 1);
+      Picky t;
+      assertUnit(s.try_pop(t) && t.value == 26);
+      assertUnit(s.empty());
+   }  // teardown
+
+   /***************************************
+    * MANY THREADS
+    ***************************************/
+
+   // four threads push and pop at once; every value comes off exactly once
+   void test_threads_pushPop()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      const int numThreads = 4;
+      const int perThread = 20000;
+      std::vector<std::vector<int>> popped(numThreads);
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&s, &popped, t, perThread]()
+         {
+            int value = 0;
+            for (int i = 0; i < perThread; i++)
+            {
+               s.push(t * perThread + i);
+               if (i % 2 && s.try_pop(value))
+                  popped[t].push_back(value);
+            }
+            while (s.try_pop(value))
+               popped[t].push_back(value);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      std::vector<int> seen(numThreads * perThread, 0);
+      for (int t = 0; t < numThreads; t++)
+         for (size_t i = 0; i < popped[t].size(); i++)
+            seen[popped[t][i]]++;
+      bool once = true;
+      for (size_t i = 0; i < seen.size(); i++)
+         once = once && seen[i] == 1;
+      assertUnit(once);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // batches pushed from several threads stay in one piece
+   void test_threads_pushRangeTogether()
+   {  // setup
+      custom::concurrent_stack<int> s;
+      const int numThreads = 4;
+      const int numBatches = 1000;
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&s, t, numBatches]()
+         {
+            int batch[8];
+            for (int b = 0; b < numBatches; b++)
+            {
+               for (int i = 0; i < 8; i++)
+                  batch[i] = ((t * numBatches + b) << 3) + i;
+               s.push_range(batch, batch + 8);
+            }
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify: every 8 pops is one batch, 7 down to 0
+      bool together = true;
+      int num = 0;
+      int value = 0;
+      int expected = 0;
+      while (s.try_pop(value))
+      {
+         if (num % 8 == 0)
+            expected = value;
+         together = together && value == expected && value % 8 == 7 - num % 8;
+         expected--;
+         num++;
+      }
+      assertUnit(together);
+      assertUnit(num == numThreads * numBatches * 8);
+   }  // teardown
+};
+
+#endif // DEBUG
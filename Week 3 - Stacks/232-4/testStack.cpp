@@ -15,6 +15,8 @@
 #include "testStack.h"       // for the stack unit tests
 #include "testVector.h"
 #include "testSpy.h"         // for the spy unit tests
+#include "testConcurrentStack.h" // for the concurrent stack unit tests
+#include "testStaticStack.h" // for the static stack unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -29,6 +31,8 @@ int main()
     TestVector tester = TestVector();
     tester.run();
    TestStack().run();
+   TestConcurrentStack().run();
+   TestStaticStack().run();
 #endif // DEBUG
   
    return 0;
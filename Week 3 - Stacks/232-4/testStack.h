@@ -11,6 +11,7 @@
 
 #ifdef DEBUG
 #include "stack.h"
+#include "cow_vector.h"
 #include "unitTest.h"
 #include "spy.h"
 
@@ -21,6 +22,24 @@
 #include <stack>
 #include <vector>
 #include <list>
+#include <deque>
+
+/*************************************************************
+ * ARENA
+ * A minimal allocator that hands out slots from a caller's
+ * slab and never frees, so a test can see where memory went
+ *************************************************************/
+struct Arena
+{
+    typedef int value_type;
+    int * next;
+    int used;
+    Arena(int * slab) : next(slab), used(0) {}
+    int * allocate(size_t n)        { used += (int)n; int * p = next; next += n; return p; }
+    void deallocate(int *, size_t)  { }
+    bool operator == (const Arena & rhs) const { return next == rhs.next; }
+    bool operator != (const Arena & rhs) const { return next != rhs.next; }
+};
 
 class TestStack : public UnitTest
 {
@@ -31,12 +50,16 @@ public:
         
         // Construct
         test_construct_default();
+        test_construct_allocator();
         test_constructCopy_empty();
         test_constructCopy_standard();
         test_constructCopy_partiallyFilled();
+        test_constructCopy_cowShares();
         test_constructMove_empty();
         test_constructMove_standard();
         test_constructMove_partiallyFilled();
+        test_constructContainer_copy();
+        test_constructContainer_move();
         test_destructor_empty();
         test_destructor_standard();
         test_destructor_partiallyFilled();
@@ -60,6 +83,7 @@ public:
         test_top_readStandard();
         test_top_writeOne();
         test_top_writeStandard();
+        test_top_writeBool();
         
         // Insert
         test_pushCopy_empty();
@@ -82,6 +106,11 @@ public:
         test_empty_empty();
         test_empty_standard();
         
+        // Container
+        test_container_deque();
+        test_container_list();
+        test_container_bare();
+        
         report("Stack");
     }
     
@@ -124,6 +153,23 @@ public:
     }
     
     
+    // the allocator handed to the stack is the one the container grows with
+    void test_construct_allocator()
+    {  // setup
+        int slab[16];
+        // exercise
+        custom::stack<int, custom::vector<int, Arena>> s(Arena{slab});
+        s.push(26);
+        s.push(49);
+        s.push(67);
+        // verify
+        assertUnit(s.size() == 3);
+        assertUnit(s.top() == 67);
+        assertUnit(s.container.alloc.used == 1 + 2 + 4);  // grew 1, 2, 4
+        assertUnit(s.container.data >= slab && s.container.data < slab + 16);
+    }  // teardown
+    
+    
     /***************************************
      * DESTRUCTOR
      ***************************************/
@@ -298,6 +344,29 @@ public:
         teardownStandardFixture(sSrc);
         teardownStandardFixture(sDest);
     }
+
+    // copying a stack kept in a cow_vector shares the buffer: no Spy is copied
+    void test_constructCopy_cowShares()
+    {  // setup
+        custom::stack<Spy, custom::cow_vector<Spy>> sSrc;
+        sSrc.push(Spy(26));
+        sSrc.push(Spy(49));
+        Spy::reset();
+        // exercise
+        custom::stack<Spy, custom::cow_vector<Spy>> sDest(sSrc);
+        // verify
+        assertUnit(Spy::numCopy() == 0);
+        assertUnit(Spy::numAlloc() == 0);
+        assertUnit(sDest.container.use_count() == 2);
+        assertUnit(sDest.size() == 2);
+        // exercise
+        sDest.pop();
+        // verify
+        assertUnit(Spy::numCopy() == 2);     // detach [26,49]
+        assertUnit(sDest.size() == 1);
+        assertUnit(sSrc.size() == 2);
+        assertUnit(sSrc.top() == Spy(49));
+    }   // teardown
     
     
     /***************************************
@@ -400,6 +469,47 @@ public:
     }
     
     
+    /***************************************
+     * CONSTRUCT FROM A CONTAINER
+     ***************************************/
+    
+    // the stack copies the container it is given; the back is the top
+    void test_constructContainer_copy()
+    {  // setup
+        custom::vector<Spy> v{Spy(26), Spy(49)};
+        Spy::reset();
+        // exercise
+        custom::stack<Spy> s(v);
+        // verify
+        assertUnit(Spy::numCopy() == 2);
+        assertUnit(Spy::numAlloc() == 2);        // each Spy copy owns an int
+        assertUnit(v.size() == 2);
+        assertUnit(s.size() == 2);
+        assertUnit(s.top() == Spy(49));
+        // teardown
+        teardownStandardFixture(s);
+    }
+    
+    // a container moved in keeps its buffer: nothing is copied or moved
+    void test_constructContainer_move()
+    {  // setup
+        custom::vector<Spy> v{Spy(26), Spy(49), Spy(67)};
+        Spy * pBuffer = v.data;
+        Spy::reset();
+        // exercise
+        custom::stack<Spy> s(std::move(v));
+        // verify
+        assertUnit(Spy::numCopy() == 0);
+        assertUnit(Spy::numCopyMove() == 0);
+        assertUnit(Spy::numAlloc() == 0);
+        assertUnit(s.container.data == pBuffer);
+        assertUnit(v.size() == 0);
+        assertUnit(s.top() == Spy(67));
+        // teardown
+        teardownStandardFixture(s);
+    }
+    
+    
     /***************************************
      * ASSIGN COPY
      ***************************************/
@@ -999,6 +1109,22 @@ public:
         teardownStandardFixture(s);
     }
     
+    // a stack of flags hands back a real bool &
+    void test_top_writeBool()
+    {  // setup
+        custom::stack<bool> s;
+        s.push(true);
+        s.push(false);
+        // exercise
+        bool & b = s.top();
+        b = true;
+        // verify
+        assertUnit(s.size() == 2);
+        assertUnit(s.container.back() == true);
+        s.pop();
+        assertUnit(s.top() == true);
+    }   // teardown
+    
     
     /***************************************
      * PUSH - COPY
@@ -1198,7 +1324,6 @@ public:
         test_stack.pop();
         assert(test_stack.size() == 0);
         
-        std::cout << test_stack.top() << std::endl;
         test_stack.container.clear();
         
     }
@@ -1231,6 +1356,68 @@ public:
         
     }
         
+    /***************************************
+     * CONTAINER
+     ***************************************/
+    
+    // a deque works as the container
+    void test_container_deque()
+    {  // setup
+        custom::stack<int, std::deque<int>> s(std::deque<int>{26, 49});
+        // exercise
+        s.push(67);
+        s.emplace(89);
+        s.pop();
+        // verify
+        assertUnit(s.size() == 3);
+        assertUnit(s.top() == 67);
+        assertUnit(s.container.front() == 26);
+    }  // teardown
+    
+    // so does a list, and two list stacks swap
+    void test_container_list()
+    {  // setup
+        custom::stack<Spy, std::list<Spy>> sLeft;
+        custom::stack<Spy, std::list<Spy>> sRight;
+        sLeft.push(Spy(26));
+        sRight.emplace(49);
+        sRight.emplace(67);
+        // exercise
+        sLeft.swap(sRight);
+        // verify
+        assertUnit(sLeft.size() == 2);
+        assertUnit(sLeft.top() == Spy(67));
+        assertUnit(sRight.size() == 1);
+        assertUnit(sRight.top() == Spy(26));
+    }  // teardown
+    
+    // a container with nothing but back, push_back, pop_back and size,
+    // the way custom::deque is: no allocator_type, emplace_back or swap
+    void test_container_bare()
+    {  // setup
+        struct Bare
+        {
+            std::vector<int> items;
+            int & back()                { return items.back();   }
+            const int & back() const    { return items.back();   }
+            void push_back(const int & t) { items.push_back(t);  }
+            void pop_back()             { items.pop_back();      }
+            size_t size() const         { return items.size();   }
+        };
+        custom::stack<int, Bare> sLeft;
+        custom::stack<int, Bare> sRight;
+        // exercise
+        sLeft.push(26);
+        sLeft.emplace(49);
+        sRight.push(67);
+        sLeft.swap(sRight);
+        // verify
+        assertUnit(sLeft.size() == 1);
+        assertUnit(sLeft.top() == 67);
+        assertUnit(sRight.size() == 2);
+        assertUnit(sRight.top() == 49);
+    }  // teardown
+    
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
@@ -0,0 +1,369 @@
+/***********************************************************************
+ * Header:
+ *    TEST STATIC STACK
+ * Summary:
+ *    Unit tests for static_stack
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "static_stack.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <stdexcept>
+
+/***************************************
+ * FUSSY
+ * Counts the live copies through pLive, and
+ * refuses to be copied or moved when negative
+ ***************************************/
+struct Fussy
+{
+   int value;
+   int * pLive;
+   Fussy(int v, int * p) : value(v), pLive(p) { (*pLive)++; }
+   Fussy(const Fussy & rhs) : value(rhs.value), pLive(rhs.pLive)
+   {
+      if (value < 0)
+         throw std::invalid_argument("negative");
+      (*pLive)++;
+   }
+   Fussy(Fussy && rhs) : value(rhs.value), pLive(rhs.pLive)
+   {
+      if (value < 0)
+         throw std::invalid_argument("negative");
+      (*pLive)++;
+   }
+   ~Fussy() { (*pLive)--; }
+};
+
+class TestStaticStack : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy();
+      test_constructMove();
+      test_constructCopy_throwDestroysBuilt();
+      test_constructMove_throwDestroysBuilt();
+      test_destructor_destroysAll();
+
+      // Assign
+      test_assignCopy_shorterToLonger();
+      test_assignCopy_longerToShorter();
+      test_swap_unequal();
+
+      // Access
+      test_top_emptyThrows();
+
+      // Insert
+      test_push_inline();
+      test_push_fullThrows();
+      test_tryPush_full();
+
+      // Remove
+      test_pop_destroysTop();
+      test_pop_empty();
+
+      report("StaticStack");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing built
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::static_stack<Spy, 64> s;
+      // verify
+      assertUnit(s.size() == 0);
+      assertUnit(s.empty());
+      assertUnit(!s.full());
+      assertUnit(s.capacity() == 64);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // a copy has copies of every element, bottom to top
+   void test_constructCopy()
+   {  // setup
+      custom::static_stack<Spy, 4> sSrc;
+      sSrc.push(Spy(26));
+      sSrc.push(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::static_stack<Spy, 4> sDest(sSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(sDest.size() == 2);
+      assertUnit(sDest.slot(0) == Spy(26));
+      assertUnit(sDest.top() == Spy(49));
+      assertUnit(sSrc.size() == 2);
+   }  // teardown
+
+   // inline elements cannot be stolen, so each is moved once
+   void test_constructMove()
+   {  // setup
+      custom::static_stack<Spy, 4> sSrc;
+      sSrc.push(Spy(26));
+      sSrc.push(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::static_stack<Spy, 4> sDest(std::move(sSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numDestructor() == 2);     // the moved-from [26,49]
+      assertUnit(sSrc.empty());
+      assertUnit(sDest.size() == 2);
+      assertUnit(sDest.top() == Spy(49));
+   }  // teardown
+
+   // a copy that throws part way leaves nothing of the new stack alive
+   void test_constructCopy_throwDestroysBuilt()
+   {  // setup
+      int live = 0;
+      custom::static_stack<Fussy, 4> sSrc;
+      sSrc.emplace(26, &live);
+      sSrc.emplace(49, &live);
+      sSrc.emplace(-1, &live);
+      bool threw = false;
+      // exercise
+      try
+      {
+         custom::static_stack<Fussy, 4> sDest(sSrc);
+      }
+      catch (const std::invalid_argument &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(live == 3);                     // only sSrc's [26,49,-1]
+      assertUnit(sSrc.size() == 3);
+   }  // teardown
+
+   // a move that throws part way leaves nothing of the new stack alive
+   void test_constructMove_throwDestroysBuilt()
+   {  // setup
+      int live = 0;
+      custom::static_stack<Fussy, 4> sSrc;
+      sSrc.emplace(26, &live);
+      sSrc.emplace(49, &live);
+      sSrc.emplace(-1, &live);
+      bool threw = false;
+      // exercise
+      try
+      {
+         custom::static_stack<Fussy, 4> sDest(std::move(sSrc));
+      }
+      catch (const std::invalid_argument &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(live == 3);                     // only sSrc's [26,49,-1]
+      assertUnit(sSrc.size() == 3);
+   }  // teardown
+
+   // everything still on the stack is destroyed with it
+   void test_destructor_destroysAll()
+   {  // setup
+      {
+         custom::static_stack<Spy, 4> s;
+         s.push(Spy(26));
+         s.push(Spy(49));
+         s.push(Spy(67));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+   }
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // the two shared slots are assigned and the third is built
+   void test_assignCopy_shorterToLonger()
+   {  // setup
+      custom::static_stack<Spy, 4> sSrc;
+      sSrc.push(Spy(26));
+      sSrc.push(Spy(49));
+      sSrc.push(Spy(67));
+      custom::static_stack<Spy, 4> sDest;
+      sDest.push(Spy(11));
+      sDest.push(Spy(99));
+      Spy::reset();
+      // exercise
+      sDest = sSrc;
+      // verify
+      assertUnit(Spy::numAssign() == 2);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(sDest.size() == 3);
+      assertUnit(sDest.slot(0) == Spy(26));
+      assertUnit(sDest.top() == Spy(67));
+   }  // teardown
+
+   // the slot rhs does not have is destroyed
+   void test_assignCopy_longerToShorter()
+   {  // setup
+      custom::static_stack<Spy, 4> sSrc;
+      sSrc.push(Spy(26));
+      custom::static_stack<Spy, 4> sDest;
+      sDest.push(Spy(11));
+      sDest.push(Spy(99));
+      Spy::reset();
+      // exercise
+      sDest = sSrc;
+      // verify
+      assertUnit(Spy::numAssign() == 1);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(sDest.size() == 1);
+      assertUnit(sDest.top() == Spy(26));
+   }  // teardown
+
+   // one element swapped, the extra one moved across
+   void test_swap_unequal()
+   {  // setup
+      custom::static_stack<int, 4> sLeft;
+      sLeft.push(26);
+      custom::static_stack<int, 4> sRight;
+      sRight.push(49);
+      sRight.push(67);
+      // exercise
+      sLeft.swap(sRight);
+      // verify
+      assertUnit(sLeft.size() == 2);
+      assertUnit(sLeft.slot(0) == 49);
+      assertUnit(sLeft.top() == 67);
+      assertUnit(sRight.size() == 1);
+      assertUnit(sRight.top() == 26);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // nothing on top
+   void test_top_emptyThrows()
+   {  // setup
+      custom::static_stack<int, 4> s;
+      bool threw = false;
+      // exercise
+      try
+      {
+         s.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the elements live inside the object itself
+   void test_push_inline()
+   {  // setup
+      custom::static_stack<int, 64> s;
+      // exercise
+      for (int i = 0; i < 64; i++)
+         s.push(i);
+      // verify
+      const char * pBegin = reinterpret_cast<const char *>(&s);
+      const char * pTop = reinterpret_cast<const char *>(&s.top());
+      assertUnit(pTop >= pBegin && pTop < pBegin + sizeof(s));
+      assertUnit(sizeof(s) <= 64 * sizeof(int) + sizeof(size_t) + alignof(size_t));
+      assertUnit(s.full());
+      assertUnit(s.top() == 63);
+   }  // teardown
+
+   // push past N throws and leaves the stack as it was
+   void test_push_fullThrows()
+   {  // setup
+      custom::static_stack<int, 2> s;
+      s.push(26);
+      s.push(49);
+      bool threw = false;
+      // exercise
+      try
+      {
+         s.push(67);
+      }
+      catch (const std::length_error &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(s.size() == 2);
+      assertUnit(s.top() == 49);
+   }  // teardown
+
+   // try_push past N says no and builds nothing
+   void test_tryPush_full()
+   {  // setup
+      custom::static_stack<Spy, 2> s;
+      Spy spy(67);
+      assertUnit(s.try_push(Spy(26)));
+      assertUnit(s.try_push(Spy(49)));
+      Spy::reset();
+      // exercise
+      bool pushed = s.try_push(spy);
+      // verify
+      assertUnit(!pushed);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(s.size() == 2);
+      assertUnit(s.top() == Spy(49));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop destroys only the top
+   void test_pop_destroysTop()
+   {  // setup
+      custom::static_stack<Spy, 4> s;
+      s.push(Spy(26));
+      s.push(Spy(49));
+      Spy::reset();
+      // exercise
+      s.pop();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(s.size() == 1);
+      assertUnit(s.top() == Spy(26));
+   }  // teardown
+
+   // popping nothing does nothing
+   void test_pop_empty()
+   {  // setup
+      custom::static_stack<int, 4> s;
+      // exercise
+      s.pop();
+      // verify
+      assertUnit(s.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
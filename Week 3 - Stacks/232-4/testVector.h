@@ -14,12 +14,16 @@
 #include <vector>
 #include "vector.h"
 #include "unitTest.h"
+#include "spy.h"
 
 
 #include <cassert>
 #include <memory>
 
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
 
 class TestVector : public UnitTest
 {
@@ -51,6 +55,8 @@ public:
       test_assign_sameSize();
       test_assign_rightBigger();
       test_assign_leftBigger();
+      test_spy_assignReusesBuffer();
+      test_spy_assignShorterDestroysExtra();
       test_assignMove_empty();
       test_assignMove_sameSize();
       test_assignMove_rightBigger();
@@ -70,10 +76,21 @@ public:
       test_iterator_construct_default();
       test_iterator_construct_pointer();
       test_iterator_construct_index();
+      test_iterator_arithmetic();
+      test_iterator_difference();
+      test_iterator_compare();
+      test_iterator_subscript();
+      test_iterator_traits();
+      test_iterator_sort();
+      test_iterator_lowerBound();
+      test_constIterator_fromIterator();
+      test_constIterator_cbegin();
+      test_reverseIterator_walk();
 
       // Access
       test_subscript_read();
       test_subscript_write();
+      test_subscript_boolReference();
       test_front_read();
       test_front_write();
       test_back_read();
@@ -86,6 +103,22 @@ public:
       test_pushback_moveEmpty();
       test_pushback_moveExcessCapacity();
       test_pushback_moveRequireReallocate();
+      test_emplaceback_excessCapacity();
+      test_emplaceback_requireReallocate();
+      test_emplace_middle();
+      test_emplace_end();
+      test_insert_middleRoom();
+      test_insert_requireReallocate();
+      test_insert_fillMiddle();
+      test_insert_rangeForwardGrowsOnce();
+      test_insert_rangeInput();
+      test_insert_initializerList();
+      test_insert_selfReference();
+      test_spy_insertReallocateMovesOnce();
+      test_erase_middle();
+      test_erase_range();
+      test_erase_last();
+      test_spy_eraseDestroysOne();
       test_resize_emptyZero();
       test_resize_emptyFourDefault();
       test_resize_emptyFourValue();
@@ -111,6 +144,7 @@ public:
       test_shrink_toEmpty();
       test_shrink_standard();
       test_shrink_twoExtraSlots();
+      test_shrink_releasesBuffer();
 
       // Status
       test_size_empty();
@@ -119,6 +153,24 @@ public:
       test_empty_full();
       test_capacity_empty();
       test_capacity_full();
+      test_memoryUsage();
+
+      // Growth policy
+      test_growth_doubling();
+      test_growth_oneAndAHalf();
+      test_growth_sizeClass();
+      test_growth_sizeClassRoundsUp();
+      test_growth_fixed();
+
+      // Element lifetime
+      test_spy_constructSizeFour();
+      test_spy_reserveStandardTen();
+      test_spy_pushbackRequireReallocate();
+      test_spy_pushbackMoveRequireReallocate();
+      test_spy_reserveThrowingMove();
+      test_reserve_nestedMovesBuffers();
+      test_spy_popback();
+      test_spy_clear();
 
       report("Vector");
    }
@@ -260,7 +312,7 @@ public:
          //    | 26 | 49 |    |    |
          //    +----+----+----+----+
          custom::vector<int> v;
-         v.data = new int[4];
+         v.data = v.alloc.allocate(4);
          v.data[0] = 99;
          v.data[1] = 99;
          v.numElements = 2;
@@ -319,7 +371,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];
+      vSrc.data = vSrc.alloc.allocate(4);
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -403,7 +455,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];\
+      vSrc.data = vSrc.alloc.allocate(4);\
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -626,7 +678,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -650,7 +702,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -674,7 +726,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -753,7 +805,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -787,7 +839,7 @@ public:
       //    | 26 | 49 | 67 | 89 |    |    |
       //    +----+----+----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[6];
+      v.data = v.alloc.allocate(6);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -804,6 +856,25 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+
+   // shrink_to_fit moves the elements into a buffer of exactly their size
+   void test_shrink_releasesBuffer()
+   {  // setup
+      custom::vector<int> v;
+      v.reserve(100);
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      int * pOld = v.data;
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.data != pOld);
+      assertUnit(v.numCapacity == 3);
+      assertUnit(v.numElements == 3);
+      assertUnit(v[0] == 26);
+      assertUnit(v[2] == 67);
+   }  // teardown
    
    /***************************************
     * SIZE EMPTY CAPACITY
@@ -897,6 +968,27 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+
+   // bytes reserved against bytes in use
+   void test_memoryUsage()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 |    |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      v.numElements = 3;
+      // exercise
+      custom::vector<int>::memory m = v.memory_usage();
+      // verify
+      assertUnit(m.reserved == 4 * sizeof(int));
+      assertUnit(m.used == 3 * sizeof(int));
+      v.numElements = 4;
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
    
    /***************************************
     * ASSIGN COPY
@@ -966,7 +1058,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = vDest.alloc.allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -998,7 +1090,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = vSrc.alloc.allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1043,6 +1135,59 @@ public:
       teardownStandardFixture(vSrc);
       teardownStandardFixture(vDest);
    }
+
+   // assignment into a buffer with room: assign, then copy, no allocation
+   void test_spy_assignReusesBuffer()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> vSrc{Spy(26), Spy(49), Spy(67), Spy(89)};
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 99 | 99 |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> vDest;
+      vDest.reserve(4);
+      vDest.push_back(Spy(99));
+      vDest.push_back(Spy(99));
+      Spy * pBuffer = vDest.data;
+      Spy::reset();
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(Spy::numAssign() == 2);         // assign [26,49]
+      assertUnit(Spy::numCopy() == 2);           // copy [67,89]
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(vDest.data == pBuffer);
+      assertUnit(vDest.numCapacity == 4);
+      assertUnit(vDest.numElements == 4);
+      if (vDest.numElements == 4)
+      {
+         assertUnit(vDest[0] == Spy(26));
+         assertUnit(vDest[3] == Spy(89));
+      }
+   }  // teardown
+
+   // assigning fewer elements destroys the extras and keeps the buffer
+   void test_spy_assignShorterDestroysExtra()
+   {  // setup
+      custom::vector<Spy> vSrc{Spy(26), Spy(49)};
+      custom::vector<Spy> vDest{Spy(99), Spy(99), Spy(99), Spy(99)};
+      Spy * pBuffer = vDest.data;
+      Spy::reset();
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(Spy::numAssign() == 2);         // assign [26,49]
+      assertUnit(Spy::numDestructor() == 2);     // destroy [99,99]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vDest.data == pBuffer);
+      assertUnit(vDest.numCapacity == 4);
+      assertUnit(vDest.numElements == 2);
+   }  // teardown
    
    // assignment when there is nothing to copy
    void test_assignMove_empty()
@@ -1078,9 +1223,7 @@ public:
       // exercise
       vDest = std::move(vSrc);
       // verify
-      assertUnit(vDest.data != vSrc.data);
-      assertUnit(vSrc.numCapacity == 4);
-      assertUnit(vSrc.numElements == 0);
+      assertEmptyFixture(vSrc);
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 89 |
@@ -1105,7 +1248,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = vDest.alloc.allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1113,9 +1256,7 @@ public:
       // exercise
       vDest = std::move(vSrc);
       // verify
-      assertUnit(vDest.data != vSrc.data);
-      assertUnit(vSrc.numCapacity == 4);
-      assertUnit(vSrc.numElements == 0);
+      assertEmptyFixture(vSrc);
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 89 |
@@ -1134,7 +1275,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = vSrc.alloc.allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1153,7 +1294,7 @@ public:
       //    +----+----+
       //    | 99 | 99 |
       //    +----+----+
-      assertUnit(vDest.numCapacity == 4);
+      assertUnit(vDest.numCapacity == 2);
       assertUnit(vDest.numElements == 2);
       assertUnit(vDest.data != nullptr);
       if (vDest.data)
@@ -1161,8 +1302,7 @@ public:
          assertUnit(vDest.data[0] == 99);
          assertUnit(vDest.data[1] == 99);
       }
-      assertUnit(vSrc.numCapacity == 2);
-      assertUnit(vSrc.numElements == 0);
+      assertEmptyFixture(vSrc);
       // teardown
       teardownStandardFixture(vSrc);
       teardownStandardFixture(vDest);
@@ -1245,7 +1385,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = vDest.alloc.allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1284,7 +1424,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = vSrc.alloc.allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1378,6 +1518,19 @@ public:
       teardownStandardFixture(v);
    }
    
+   // vector <bool> is a plain array of bools: a real bool & comes back
+   void test_subscript_boolReference()
+   {  // setup
+      custom::vector<bool> v{ true, false, true };
+      // exercise
+      bool & b = v[1];
+      b = true;
+      // verify
+      assertUnit(v.data[1] == true);
+      assertUnit(&v[2] == &v[1] + 1);
+      assertUnit(&v.back() == v.data + 2);
+   }  // teardown
+   
    // verify that we can look at the front of a fector
    void test_front_read()
    {  // setup
@@ -1525,7 +1678,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1592,7 +1745,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1650,7 +1803,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1680,7 +1833,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = v.alloc.allocate(3);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1749,7 +1902,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = v.alloc.allocate(4);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1782,7 +1935,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = v.alloc.allocate(3);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1817,6 +1970,329 @@ public:
    }
    
    
+   /***************************************
+    * EMPLACE
+    ***************************************/
+   
+   // build the element in place when there is room. No temporaries
+   void test_emplaceback_excessCapacity()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      v.data = v.alloc.allocate(4);
+      v.alloc.construct(&v.data[0], Spy(26));
+      v.alloc.construct(&v.data[1], Spy(49));
+      v.numElements = 2;
+      v.numCapacity = 4;
+      Spy::reset();
+      // exercise
+      Spy & s = v.emplace_back(67);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);     // construct [67]
+      assertUnit(Spy::numAlloc() == 1);          // allocate [67]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 |    |
+      //    +----+----+----+----+
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      assertUnit(&s == v.data + 2);
+      assertUnit(s.get() == 67);
+   }  // teardown
+   
+   // build the element in the new buffer when there is not room
+   void test_emplaceback_requireReallocate()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.emplace_back(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);     // construct [99]
+      assertUnit(Spy::numCopyMove() == 4);       // move [26,49,67,89]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 4);     // destroy empty [26,49,67,89]
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 | 99 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      if (v.data && v.numElements == 5)
+         assertUnit(v.data[4] == Spy(99));
+   }  // teardown
+   
+   // insert into the middle, shifting the tail up one slot
+   void test_emplace_middle()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::iterator it = v.emplace(custom::vector<int>::iterator(1, v), 30);
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 30 | 49 | 67 | 89 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(it.p == v.data + 1);
+      if (v.data && v.numElements == 5)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 30);
+         assertUnit(v.data[2] == 49);
+         assertUnit(v.data[3] == 67);
+         assertUnit(v.data[4] == 89);
+      }
+      // teardown
+      teardownStandardFixture(v);
+   }
+   
+   // insert at end() is the same as emplace_back
+   void test_emplace_end()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      custom::vector<int>::iterator it = v.emplace(v.end(), 99);
+      // verify
+      //      0
+      //    +----+
+      //    | 99 |
+      //    +----+
+      assertUnit(v.numCapacity == 1);
+      assertUnit(v.numElements == 1);
+      assertUnit(it.p == v.data);
+      if (v.data)
+         assertUnit(v.data[0] == 99);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // room for one more: the tail shifts up in the same buffer
+   void test_insert_middleRoom()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 |    |
+      //    +----+----+----+----+
+      custom::vector<int> v{26, 49, 67};
+      v.reserve(4);
+      int * pBuffer = v.data;
+      // exercise
+      custom::vector<int>::iterator it = v.insert(v.begin() + 1, 30);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 30 | 49 | 67 |
+      //    +----+----+----+----+
+      assertUnit(v.data == pBuffer);
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 30);
+      assertUnit(v.data[2] == 49);
+      assertUnit(v.data[3] == 67);
+   }  // teardown
+
+   // no room: the new element and the old ones meet in a new buffer
+   void test_insert_requireReallocate()
+   {  // setup
+      custom::vector<int> v{26, 49};
+      // exercise
+      custom::vector<int>::iterator it = v.insert(v.begin(), 11);
+      // verify
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      assertUnit(it.p == v.data);
+      assertUnit(v.data[0] == 11);
+      assertUnit(v.data[1] == 26);
+      assertUnit(v.data[2] == 49);
+   }  // teardown
+
+   // three copies of 7 in the middle
+   void test_insert_fillMiddle()
+   {  // setup
+      custom::vector<int> v{26, 49};
+      // exercise
+      v.insert(v.begin() + 1, 3, 7);
+      // verify
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 7);
+      assertUnit(v.data[3] == 7);
+      assertUnit(v.data[4] == 49);
+   }  // teardown
+
+   // a forward range is measured first, so the buffer grows once
+   void test_insert_rangeForwardGrowsOnce()
+   {  // setup
+      custom::vector<int> v{26, 89};
+      std::vector<int> vSrc{49, 55, 60, 67, 80};
+      // exercise
+      v.insert(v.begin() + 1, vSrc.begin(), vSrc.end());
+      // verify
+      assertUnit(v.numCapacity == 7);           // straight to 7, not 4 then 8
+      assertUnit(v.numElements == 7);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[5] == 80);
+      assertUnit(v.data[6] == 89);
+   }  // teardown
+
+   // a single-pass range is appended and rotated into place
+   void test_insert_rangeInput()
+   {  // setup
+      custom::vector<int> v{89, 99};
+      std::istringstream in("26 49 67");
+      // exercise
+      custom::vector<int>::iterator it = v.insert(v.begin(),
+         std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      assertUnit(it.p == v.data);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+      assertUnit(v.data[4] == 99);
+   }  // teardown
+
+   // {49, 67} at the end
+   void test_insert_initializerList()
+   {  // setup
+      custom::vector<int> v{26};
+      // exercise
+      v.insert(v.end(), {49, 67});
+      // verify
+      assertUnit(v.numElements == 3);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+   }  // teardown
+
+   // inserting one of our own elements copies it before anything moves
+   void test_insert_selfReference()
+   {  // setup
+      custom::vector<int> vRoom{26, 49, 67};
+      vRoom.reserve(10);
+      custom::vector<int> vFull{26, 49, 67};
+      // exercise
+      vRoom.insert(vRoom.begin(), vRoom[2]);
+      vFull.insert(vFull.begin(), vFull[2]);
+      // verify
+      assertUnit(vRoom.data[0] == 67);
+      assertUnit(vRoom.data[3] == 67);
+      assertUnit(vFull.data[0] == 67);
+      assertUnit(vFull.data[3] == 67);
+   }  // teardown
+
+   // growing moves each old element once, around the new one
+   void test_spy_insertReallocateMovesOnce()
+   {  // setup
+      custom::vector<Spy> v;
+      v.reserve(3);
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      v.push_back(Spy(67));
+      Spy s(30);
+      Spy::reset();
+      // exercise
+      v.insert(v.begin() + 1, s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);           // copy [30]
+      assertUnit(Spy::numCopyMove() == 4);       // move [30,26,49,67]
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v[1] == Spy(30));
+         assertUnit(v[3] == Spy(67));
+      }
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // the tail shifts down over the gap
+   void test_erase_middle()
+   {  // setup
+      custom::vector<int> v{26, 49, 67, 89};
+      // exercise
+      custom::vector<int>::iterator it = v.erase(v.begin() + 1);
+      // verify
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numElements == 3);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 67);
+      assertUnit(v.data[2] == 89);
+   }  // teardown
+
+   // erase [1, 3)
+   void test_erase_range()
+   {  // setup
+      custom::vector<int> v{26, 49, 67, 89};
+      // exercise
+      custom::vector<int>::iterator it = v.erase(v.begin() + 1, v.begin() + 3);
+      // verify
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 89);
+   }  // teardown
+
+   // erasing the last element returns end()
+   void test_erase_last()
+   {  // setup
+      custom::vector<int> v{26, 49};
+      // exercise
+      custom::vector<int>::iterator it = v.erase(v.begin() + 1);
+      // verify
+      assertUnit(it == v.end());
+      assertUnit(v.numElements == 1);
+   }  // teardown
+
+   // the tail is moved down and only the last slot is destroyed
+   void test_spy_eraseDestroysOne()
+   {  // setup
+      custom::vector<Spy> v{Spy(26), Spy(49), Spy(67), Spy(89)};
+      Spy::reset();
+      // exercise
+      v.erase(v.begin() + 1);
+      // verify
+      assertUnit(Spy::numAssignMove() == 2);     // move [67,89] down
+      assertUnit(Spy::numDestructor() == 1);     // the old [89] slot
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v[1] == Spy(67));
+         assertUnit(v[2] == Spy(89));
+      }
+   }  // teardown
+   
    /***************************************
     * ITERATOR
     ***************************************/
@@ -2009,6 +2485,459 @@ public:
       teardownStandardFixture(v);
    }
 
+   // jump forward and back by more than one
+   void test_iterator_arithmetic()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it = v.begin();
+      // exercise
+      it += 3;
+      custom::vector<int>::iterator itBack = it - 2;
+      custom::vector<int>::iterator itFront = 2 + v.begin();
+      // verify
+      assertUnit(it.p == v.data + 3);
+      assertUnit(itBack.p == v.data + 1);
+      assertUnit(itFront.p == v.data + 2);
+      assertUnit(*(v.begin() + 3) == 89);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // the distance between two iterators is a subtraction
+   void test_iterator_difference()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      std::ptrdiff_t n = v.end() - v.begin();
+      std::ptrdiff_t d = std::distance(v.begin(), v.end());
+      // verify
+      assertUnit(n == 4);
+      assertUnit(d == 4);
+      assertUnit(v.begin() - v.end() == -4);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // iterators order the same way as the elements they point to
+   void test_iterator_compare()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::iterator itLow = v.begin() + 1;
+      custom::vector<int>::iterator itHigh = v.begin() + 2;
+      // verify
+      assertUnit(itLow < itHigh);
+      assertUnit(itHigh > itLow);
+      assertUnit(itLow <= itLow);
+      assertUnit(itHigh >= itLow);
+      assertUnit(!(itHigh < itLow));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // an iterator can index relative to itself
+   void test_iterator_subscript()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it = v.begin() + 1;
+      // exercise
+      it[1] = 99;
+      // verify
+      assertUnit(it[-1] == 26);
+      assertUnit(it[0] == 49);
+      assertUnit(v.data[2] == 99);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // std::iterator_traits sees a random-access iterator
+   void test_iterator_traits()
+   {  // setup
+      typedef std::iterator_traits<custom::vector<int>::iterator> traits;
+      typedef std::iterator_traits<custom::vector<int>::const_iterator> ctraits;
+      // exercise
+      // verify
+      assertUnit((std::is_same<traits::iterator_category, std::random_access_iterator_tag>::value));
+      assertUnit((std::is_same<traits::value_type, int>::value));
+      assertUnit((std::is_same<traits::reference, int &>::value));
+      assertUnit((std::is_same<ctraits::value_type, int>::value));
+      assertUnit((std::is_same<ctraits::reference, const int &>::value));
+   }  // teardown
+
+   // std::sort works straight on the vector
+   void test_iterator_sort()
+   {  // setup
+      custom::vector<int> v{89, 26, 67, 49, 11};
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      assertUnit(v.numElements == 5);
+      assertUnit(v[0] == 11);
+      assertUnit(v[1] == 26);
+      assertUnit(v[2] == 49);
+      assertUnit(v[3] == 67);
+      assertUnit(v[4] == 89);
+   }  // teardown
+
+   // binary search on a sorted vector through a const reference
+   void test_iterator_lowerBound()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      const custom::vector<int> & cv = v;
+      // exercise
+      custom::vector<int>::const_iterator itFound = std::lower_bound(cv.begin(), cv.end(), 67);
+      custom::vector<int>::const_iterator itMissing = std::lower_bound(cv.begin(), cv.end(), 50);
+      custom::vector<int>::const_iterator itPast = std::lower_bound(cv.begin(), cv.end(), 99);
+      // verify
+      assertUnit(itFound - cv.begin() == 2);
+      assertUnit(itMissing - cv.begin() == 2);
+      assertUnit(itPast == cv.end());
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // an iterator converts to a const_iterator, and they compare
+   void test_constIterator_fromIterator()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it = v.begin() + 2;
+      // exercise
+      custom::vector<int>::const_iterator cit = it;
+      // verify
+      assertUnit(cit.p == v.data + 2);
+      assertUnit(*cit == 67);
+      assertUnit(cit == it);
+      assertUnit(it == cit);
+      assertUnit(v.end() - cit == 2);
+      assertUnit((!std::is_convertible<custom::vector<int>::const_iterator,
+                                       custom::vector<int>::iterator>::value));
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // cbegin and cend always give const_iterators
+   void test_constIterator_cbegin()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      int sum = 0;
+      // exercise
+      for (custom::vector<int>::const_iterator it = v.cbegin(); it != v.cend(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertUnit(v.cbegin().p == v.data);
+      assertUnit(v.cend().p == v.data + 4);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // walk the vector backwards
+   void test_reverseIterator_walk()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      int values[4] = {};
+      int i = 0;
+      // exercise
+      for (custom::vector<int>::reverse_iterator it = v.rbegin(); it != v.rend(); ++it)
+         values[i++] = *it;
+      // verify
+      assertUnit(i == 4);
+      assertUnit(values[0] == 89);
+      assertUnit(values[1] == 67);
+      assertUnit(values[2] == 49);
+      assertUnit(values[3] == 26);
+      assertUnit(*v.crbegin() == 89);
+      assertUnit(v.crend() - v.crbegin() == 4);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   /***************************************
+    * GROWTH POLICY
+    ***************************************/
+
+   // the capacities a vector passes through while 20 ints are pushed
+   template <class G>
+   std::vector<size_t> growthSequence()
+   {
+      custom::vector<int, std::allocator<int>, G> v;
+      std::vector<size_t> capacities;
+      for (int i = 0; i < 20; i++)
+      {
+         v.push_back(i);
+         if (capacities.empty() || capacities.back() != v.capacity())
+            capacities.push_back(v.capacity());
+      }
+      return capacities;
+   }
+
+   // the default: start at one and double
+   void test_growth_doubling()
+   {  // setup
+      // exercise
+      std::vector<size_t> capacities = growthSequence<custom::growth_doubling>();
+      // verify
+      assertUnit(capacities == std::vector<size_t>({1, 2, 4, 8, 16, 32}));
+   }  // teardown
+
+   // grow by half, but always by at least one
+   void test_growth_oneAndAHalf()
+   {  // setup
+      // exercise
+      std::vector<size_t> capacities = growthSequence<custom::growth_one_and_a_half>();
+      // verify
+      assertUnit(capacities == std::vector<size_t>({1, 2, 3, 4, 6, 9, 13, 19, 28}));
+   }  // teardown
+
+   // ints never get a buffer smaller than the 16-byte minimum
+   void test_growth_sizeClass()
+   {  // setup
+      // exercise
+      std::vector<size_t> capacities = growthSequence<custom::growth_size_class>();
+      // verify
+      assertUnit(capacities == std::vector<size_t>({4, 8, 16, 32}));
+   }  // teardown
+
+   // doubling 5 ints gives 40 bytes; the allocator hands out 48 anyway
+   void test_growth_sizeClassRoundsUp()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::growth_size_class> v;
+      v.reserve(5);
+      v.resize(5);
+      // exercise
+      v.push_back(99);
+      // verify
+      assertUnit(v.capacity() == 12);
+      assertUnit(v.size() == 6);
+   }  // teardown
+
+   // fixed steps of eight
+   void test_growth_fixed()
+   {  // setup
+      // exercise
+      std::vector<size_t> capacities = growthSequence<custom::growth_fixed<8>>();
+      // verify
+      assertUnit(capacities == std::vector<size_t>({8, 16, 24}));
+   }  // teardown
+
+   /***************************************
+    * ELEMENT LIFETIME
+    * Spare capacity is raw storage: elements are built in place
+    * when they become live, never default-constructed and assigned
+    ***************************************/
+
+   // four default elements, built directly in the buffer
+   void test_spy_constructSizeFour()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::vector<Spy> v(4);
+      // verify
+      assertUnit(Spy::numDefault() == 4);        // default [  ,  ,  ,  ]
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+   }  // teardown
+
+   // reserve only constructs the live elements in the new buffer
+   void test_spy_reserveStandardTen()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);       // move [26,49,67,89]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numDestructor() == 4);     // destroy empty [26,49,67,89]
+      //      0    1    2    3    4    5    6    7    8    9
+      //    +----+----+----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |    |    |    |    |
+      //    +----+----+----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 4);
+      if (v.data && v.numElements == 4)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[3] == Spy(89));
+      }
+   }  // teardown
+
+   // growth builds the new element and the survivors in place
+   void test_spy_pushbackRequireReallocate()
+   {  // setup
+      //      0    1    2
+      //    +----+----+----+
+      //    | 26 | 49 | 67 |
+      //    +----+----+----+
+      custom::vector<Spy> v;
+      v.data = v.alloc.allocate(3);
+      v.alloc.construct(&v.data[0], Spy(26));
+      v.alloc.construct(&v.data[1], Spy(49));
+      v.alloc.construct(&v.data[2], Spy(67));
+      v.numElements = 3;
+      v.numCapacity = 3;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopyMove() == 3);       // move [26,49,67]
+      assertUnit(Spy::numCopy() == 1);           // copy [99]
+      assertUnit(Spy::numAlloc() == 1);          // allocate [99]
+      assertUnit(Spy::numDestructor() == 3);     // destroy empty [26,49,67]
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 99 |    |    |
+      //    +----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 4);
+      if (v.data && v.numElements == 4)
+         assertUnit(v.data[3] == Spy(99));
+   }  // teardown
+
+   // growth through push_back(T&&) makes no copies at all
+   void test_spy_pushbackMoveRequireReallocate()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(std::move(s));
+      // verify
+      assertUnit(Spy::numCopyMove() == 5);       // move [26,49,67,89] and [99]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 4);     // destroy empty [26,49,67,89]
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 | 99 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      if (v.data && v.numElements == 5)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[4] == Spy(99));
+      }
+   }  // teardown
+
+   // a move constructor that may throw is not trusted: growth copies
+   void test_spy_reserveThrowingMove()
+   {  // setup
+      struct ThrowingMove
+      {
+         Spy s;
+         ThrowingMove(int value) : s(value) {}
+         ThrowingMove(const ThrowingMove & rhs) = default;
+         ThrowingMove(ThrowingMove && rhs) : s(std::move(rhs.s)) {}
+      };
+      custom::vector<ThrowingMove> v;
+      v.push_back(ThrowingMove(26));
+      v.push_back(ThrowingMove(49));
+      Spy::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(Spy::numCopy() == 2);           // copy [26,49]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 2);     // destroy old [26,49]
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 2);
+   }  // teardown
+
+   // a vector of vectors hands the inner buffers over instead of copying
+   void test_reserve_nestedMovesBuffers()
+   {  // setup
+      custom::vector<custom::vector<int>> v;
+      custom::vector<int> inner;
+      setupStandardFixture(inner);
+      int * pInner = inner.data;
+      v.push_back(std::move(inner));
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 1);
+      if (v.data && v.numElements == 1)
+      {
+         assertUnit(v.data[0].data == pInner);
+         assertStandardFixture(v.data[0]);
+      }
+   }  // teardown
+
+   // pop_back destroys the element it removes
+   void test_spy_popback()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);     // destroy [89]
+      assertUnit(Spy::numDelete() == 1);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+   }  // teardown
+
+   // clear destroys every element but keeps the buffer
+   void test_spy_clear()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 4);     // destroy [26,49,67,89]
+      assertUnit(Spy::numDelete() == 4);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.data != nullptr);
+   }  // teardown
+
    
    /*************************************************************
     * SETUP STANDARD FIXTURE
@@ -2022,7 +2951,7 @@ public:
       
       try
       {
-         v.data = new int[4];
+         v.data = v.alloc.allocate(4);
          v.data[0] = 26;
          v.data[1] = 49;
          v.data[2] = 67;
@@ -2036,6 +2965,24 @@ public:
       }
    }
    
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *************************************************************/
+   void setupStandardFixture(custom::vector<Spy>& v)
+   {
+      v.data = v.alloc.allocate(4);
+      v.alloc.construct(&v.data[0], Spy(26));
+      v.alloc.construct(&v.data[1], Spy(49));
+      v.alloc.construct(&v.data[2], Spy(67));
+      v.alloc.construct(&v.data[3], Spy(89));
+      v.numElements = 4;
+      v.numCapacity = 4;
+   }
+   
    /*************************************************************
     * VERIFY STANDARD FIXTURE PARAMETERS
     *      0    1    2    3
@@ -13,6 +13,7 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testList.h"       // for the spy unit tests
+#include "testUnrolledList.h" // for the unrolled list unit tests
 
 
 /**********************************************************************
@@ -24,6 +25,7 @@ int main()
 #ifdef DEBUG
    // unit tests
    TestList().run();
+   TestUnrolledList().run();
 #endif // DEBUG
    
    return 0;
@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED LIST
+ * Summary:
+ *    Unit tests for unrolled_list
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolled_list.h"
+#include "unitTest.h"
+
+#include <algorithm>
+#include <cassert>
+#include <list>
+#include <string>
+
+class TestUnrolledList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_constructCopy_samePacking();
+      test_constructMove_stealsNodes();
+      test_assign_copy();
+
+      // Insert
+      test_pushBack_fillsNodes();
+      test_pushFront();
+      test_insert_middleShifts();
+      test_insert_fullSplits();
+      test_insert_returnsNew();
+
+      // Remove
+      test_erase_middle();
+      test_erase_lastUnlinksNode();
+      test_erase_mergesNext();
+      test_erase_lastElement();
+      test_pop_bothEnds();
+
+      // Iterator
+      test_iterator_decrementFromEnd();
+      test_iterator_stdAlgorithm();
+
+      // Against std::list
+      test_mixed_matchesStdList();
+      test_memory_perElement();
+
+      report("UnrolledList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no nodes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int, 4> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // ten elements pack into nodes of 4, 4 and 2
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+      // verify
+      assertUnit(l.size() == 10);
+      assertUnit(sameAs(l, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+      assertUnit(packing(l) == "4 4 2");
+   }  // teardown
+
+   // a copy has nodes of its own, packed the same way
+   void test_constructCopy_samePacking()
+   {  // setup
+      custom::unrolled_list<std::string, 4> lSrc{"a", "b", "c", "d", "e"};
+      lSrc.erase(lSrc.begin());
+      // exercise
+      custom::unrolled_list<std::string, 4> lDest(lSrc);
+      lSrc.front() = "z";
+      // verify
+      assertUnit(lDest.pHead != lSrc.pHead);
+      assertUnit(packing(lDest) == packing(lSrc));
+      assertUnit(sameAs(lDest, {"b", "c", "d", "e"}));
+   }  // teardown
+
+   // moving hands the nodes over
+   void test_constructMove_stealsNodes()
+   {  // setup
+      custom::unrolled_list<int, 4> lSrc{26, 49, 67};
+      void * pNodes = lSrc.pHead;
+      // exercise
+      custom::unrolled_list<int, 4> lDest(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.empty());
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(lDest.pHead == pNodes);
+      assertUnit(sameAs(lDest, {26, 49, 67}));
+   }  // teardown
+
+   // assignment replaces everything
+   void test_assign_copy()
+   {  // setup
+      custom::unrolled_list<std::string, 4> lSrc{"a", "b"};
+      custom::unrolled_list<std::string, 4> lDest{"w", "x", "y", "z", "v"};
+      // exercise
+      lDest = lSrc;
+      // verify
+      assertUnit(sameAs(lDest, {"a", "b"}));
+      assertUnit(sameAs(lSrc, {"a", "b"}));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back starts a new node only when the tail is full
+   void test_pushBack_fillsNodes()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(packing(l) == "4 4 1");
+      assertUnit(l.back() == 8);
+      assertUnit(l.front() == 0);
+   }  // teardown
+
+   // push_front goes before everything
+   void test_pushFront()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      // exercise
+      for (int i = 0; i < 6; i++)
+         l.push_front(i);
+      // verify
+      assertUnit(sameAs(l, {5, 4, 3, 2, 1, 0}));
+   }  // teardown
+
+   // with room in the node, the later slots shift up
+   void test_insert_middleShifts()
+   {  // setup
+      custom::unrolled_list<int, 4> l{26, 67, 89};
+      custom::unrolled_list<int, 4>::iterator it = l.begin();
+      ++it;
+      // exercise
+      it = l.insert(it, 49);
+      // verify
+      assertUnit(*it == 49);
+      assertUnit(packing(l) == "4");
+      assertUnit(sameAs(l, {26, 49, 67, 89}));
+   }  // teardown
+
+   // a full node splits in half and the element goes in the upper half
+   void test_insert_fullSplits()
+   {  // setup
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4};
+      custom::unrolled_list<int, 4>::iterator it = l.begin();
+      ++it;
+      ++it;
+      ++it;
+      // exercise
+      it = l.insert(it, 99);
+      // verify
+      assertUnit(packing(l) == "2 3");
+      assertUnit(it.p == l.pTail);
+      assertUnit(sameAs(l, {1, 2, 3, 99, 4}));
+   }  // teardown
+
+   // the iterator returned is good even after a split
+   void test_insert_returnsNew()
+   {  // setup
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4};
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it = l.insert(l.begin(), 0);
+      // verify
+      assertUnit(*it == 0);
+      assertUnit(*++it == 1);
+      assertUnit(packing(l) == "3 2");
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase returns the element after
+   void test_erase_middle()
+   {  // setup
+      custom::unrolled_list<std::string, 4> l{"a", "b", "c", "d"};
+      custom::unrolled_list<std::string, 4>::iterator it = l.begin();
+      ++it;
+      // exercise
+      it = l.erase(it);
+      // verify
+      assertUnit(*it == "c");
+      assertUnit(l.size() == 3);
+      assertUnit(sameAs(l, {"a", "c", "d"}));
+   }  // teardown
+
+   // erasing the only element of a node frees the node
+   void test_erase_lastUnlinksNode()
+   {  // setup
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4, 5, 6, 7, 8, 9};
+      custom::unrolled_list<int, 4>::iterator it = l.end();
+      --it;
+      // exercise
+      it = l.erase(it);
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(packing(l) == "4 4");
+      assertUnit(l.back() == 8);
+   }  // teardown
+
+   // a node under half full takes in its successor when they fit
+   void test_erase_mergesNext()
+   {  // setup
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4, 5};
+      l.insert(l.begin(), 0);                    // [0 1 2] [3 4] [5]
+      custom::unrolled_list<int, 4>::iterator it = l.begin();
+      ++it;
+      ++it;
+      ++it;                                      // 3
+      // exercise
+      it = l.erase(it);                          // [0 1 2] [4 5]
+      // verify
+      assertUnit(*it == 4);
+      assertUnit(packing(l) == "3 2");
+      assertUnit(sameAs(l, {0, 1, 2, 4, 5}));
+   }  // teardown
+
+   // erasing the only element leaves no nodes
+   void test_erase_lastElement()
+   {  // setup
+      custom::unrolled_list<int, 4> l{26};
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it = l.erase(l.begin());
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // pop from both ends until empty
+   void test_pop_bothEnds()
+   {  // setup
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4, 5, 6, 7};
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertUnit(sameAs(l, {2, 3, 4, 5, 6}));
+      // exercise
+      while (!l.empty())
+         l.pop_back();
+      l.pop_back();
+      // verify
+      assertUnit(l.pHead == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // -- from end() walks back across nodes
+   void test_iterator_decrementFromEnd()
+   {  // setup
+      custom::unrolled_list<int, 4> l{1, 2, 3, 4, 5, 6};
+      custom::unrolled_list<int, 4>::iterator it = l.end();
+      int sum = 0;
+      // exercise
+      while (it != l.begin())
+         sum = sum * 10 + *--it;
+      // verify
+      assertUnit(sum == 654321);
+   }  // teardown
+
+   // the iterator works with the standard algorithms
+   void test_iterator_stdAlgorithm()
+   {  // setup
+      custom::unrolled_list<int, 4> l{3, 1, 4, 1, 5, 9, 2, 6};
+      // exercise
+      long num = (long)std::count(l.begin(), l.end(), 1);
+      custom::unrolled_list<int, 4>::iterator it = std::find(l.begin(), l.end(), 9);
+      // verify
+      assertUnit(num == 2);
+      assertUnit(it != l.end() && *it == 9);
+   }  // teardown
+
+   /***************************************
+    * AGAINST STD::LIST
+    ***************************************/
+
+   // thousands of inserts and erases all over agree with std::list
+   void test_mixed_matchesStdList()
+   {  // setup
+      custom::unrolled_list<std::string, 8> l;
+      std::list<std::string> lExpected;
+      unsigned x = 26;
+      bool same = true;
+      // exercise
+      for (int op = 0; op < 5000; op++)
+      {
+         x = x * 1664525u + 1013904223u;
+         size_t pos = lExpected.empty() ? 0 : (x >> 8) % (lExpected.size() + 1);
+         custom::unrolled_list<std::string, 8>::iterator it = l.begin();
+         std::list<std::string>::iterator itExpected = lExpected.begin();
+         for (size_t i = 0; i < pos; i++)
+         {
+            ++it;
+            ++itExpected;
+         }
+         if ((x >> 4) % 3 != 0 || itExpected == lExpected.end())
+         {
+            std::string s = std::to_string(op);
+            it = l.insert(it, s);
+            itExpected = lExpected.insert(itExpected, s);
+         }
+         else
+         {
+            it = l.erase(it);
+            itExpected = lExpected.erase(itExpected);
+         }
+         same = same && (it == l.end()) == (itExpected == lExpected.end());
+         same = same && (itExpected == lExpected.end() || *it == *itExpected);
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(l.size() == lExpected.size());
+      assertUnit(std::equal(lExpected.begin(), lExpected.end(), l.begin()));
+      assertUnit(everyNodeLive(l));
+   }  // teardown
+
+   // 32 ints to a node: a few bytes of links per element, not 20
+   void test_memory_perElement()
+   {  // setup
+      custom::unrolled_list<int, 32> l;
+      // exercise
+      for (int i = 0; i < 3200; i++)
+         l.push_back(i);
+      // verify
+      size_t numNodes = 0;
+      for (auto p = l.pHead; p; p = p->pNext)
+         numNodes++;
+      assertUnit(numNodes == 100);
+      assertUnit(numNodes * sizeof(*l.pHead) <= 3200 * (sizeof(int) + 1));
+   }  // teardown
+
+private:
+   // the elements of l, in order, are the ones listed
+   template <class T, size_t K>
+   bool sameAs(custom::unrolled_list<T, K> & l,
+               const std::initializer_list<typename custom::unrolled_list<T, K>::iterator::value_type> & il)
+   {
+      if (l.size() != il.size())
+         return false;
+      return std::equal(il.begin(), il.end(), l.begin());
+   }
+
+   // how many elements each node holds, "4 4 2"
+   template <class T, size_t K>
+   std::string packing(const custom::unrolled_list<T, K> & l)
+   {
+      std::string s;
+      for (auto p = l.pHead; p; p = p->pNext)
+         s += (s.empty() ? "" : " ") + std::to_string(p->num);
+      return s;
+   }
+
+   // no empty nodes, and the back links agree with the forward ones
+   template <class T, size_t K>
+   bool everyNodeLive(const custom::unrolled_list<T, K> & l)
+   {
+      size_t num = 0;
+      for (auto p = l.pHead; p; p = p->pNext)
+      {
+         if (p->num == 0 || p->num > K)
+            return false;
+         if (p->pNext ? p->pNext->pPrev != p : l.pTail != p)
+            return false;
+         num += p->num;
+      }
+      return num == l.size();
+   }
+};
+
+#endif // DEBUG
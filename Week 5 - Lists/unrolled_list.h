@@ -0,0 +1,497 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A doubly linked list whose nodes each hold up to K elements in
+ *    an inline array, instead of one element and two pointers.  A
+ *    list <int> spends 20 bytes of links and padding on every 4-byte
+ *    value and takes a cache miss per element to walk; an
+ *    unrolled_list <int, 32> spends the same links on 32 values and
+ *    walks them like an array.
+ *
+ *    It has list's interface: push and pop at both ends, and insert
+ *    and erase at an iterator in the middle.  Both are O(K): the
+ *    elements after the position in the same node shift by one.  A
+ *    full node splits in half on insert; a node that falls under half
+ *    full on erase pulls in its successor when they fit together.
+ *
+ *    Unlike list, insert and erase may move the other elements of the
+ *    node (and of a node split or merged with it), so they invalidate
+ *    iterators and references into that node.  The iterator returned
+ *    is always good.
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list          : A linked list of K-element arrays
+ *        unrolled_list::iterator: A bidirectional iterator by (node, index)
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t and std::ptrdiff_t
+#include <initializer_list> // for std::initializer_list
+#include <iterator>         // for std::bidirectional_iterator_tag
+#include <new>              // for placement new
+#include <utility>          // for std::move
+
+class TestUnrolledList; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * UNROLLED LIST
+ * Every node on the chain holds 1..K live elements
+ * in slots [0, num).  numElements is their total
+ **************************************************/
+template <typename T, size_t K = 32>
+class unrolled_list
+{
+   static_assert(K >= 2, "unrolled_list needs at least two elements per node");
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+
+   unrolled_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+   unrolled_list(size_t num, const T & t);
+   unrolled_list(const std::initializer_list<T> & il);
+   template <class Iterator>
+   unrolled_list(Iterator first, Iterator last);
+   unrolled_list(const unrolled_list &  rhs);
+   unrolled_list(      unrolled_list && rhs) noexcept;
+   ~unrolled_list() { clear(); }
+
+   //
+   // Assign
+   //
+
+   unrolled_list & operator = (const unrolled_list &  rhs);
+   unrolled_list & operator = (      unrolled_list && rhs) noexcept;
+   void swap(unrolled_list & rhs) noexcept
+   {
+      std::swap(numElements, rhs.numElements);
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() { return iterator(pHead, 0); }
+   iterator end()   { return pTail ? iterator(pTail, pTail->num) : iterator(); }
+
+   //
+   // Access
+   //
+
+   T & front()             { assert(pHead); return pHead->at(0);              }
+   const T & front() const { assert(pHead); return pHead->at(0);              }
+   T & back()              { assert(pTail); return pTail->at(pTail->num - 1); }
+   const T & back()  const { assert(pTail); return pTail->at(pTail->num - 1); }
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  t) { insert(begin(), t);            }
+   void push_front(      T && t) { insert(begin(), std::move(t)); }
+   void push_back (const T &  t) { insert(end(), t);              }
+   void push_back (      T && t) { insert(end(), std::move(t));   }
+   iterator insert(iterator it, const T &  t) { return insert(it, T(t)); }
+   iterator insert(iterator it,       T && t);
+
+   //
+   // Remove
+   //
+
+   void pop_front() { if (pHead) erase(begin());                       }
+   void pop_back()  { if (pTail) erase(iterator(pTail, pTail->num - 1)); }
+   iterator erase(iterator it);
+   void clear();
+
+   //
+   // Status
+   //
+
+   bool   empty() const { return numElements == 0; }
+   size_t size()  const { return numElements;      }
+
+private:
+   struct Node
+   {
+      Node() : pNext(nullptr), pPrev(nullptr), num(0) {}
+      T & at(size_t i) { return *reinterpret_cast<T *>(slots + i * sizeof(T)); }
+      T * slot(size_t i) { return reinterpret_cast<T *>(slots + i * sizeof(T)); }
+
+      Node * pNext;
+      Node * pPrev;
+      size_t num;                                   // slots [0, num) are live
+      alignas(T) unsigned char slots[K * sizeof(T)];
+   };
+
+   Node * linkAfter(Node * pNode);
+   void unlink(Node * pNode);
+   static void moveSlots(Node * pDest, size_t iDest, Node * pSrc, size_t iSrc, size_t num);
+   static void shiftUp(Node * pNode, size_t i);
+   static void shiftDown(Node * pNode, size_t i);
+
+   size_t numElements;  // elements in all the nodes
+   Node * pHead;        // the first node
+   Node * pTail;        // the last node
+};
+
+/*************************************************
+ * UNROLLED LIST ITERATOR
+ * A node and an index into it.  end() is one past
+ * the last element of the tail node, so -- from
+ * end() reaches back()
+ ************************************************/
+template <typename T, size_t K>
+class unrolled_list <T, K> :: iterator
+{
+   friend class ::TestUnrolledList;
+   friend class unrolled_list;
+public:
+   typedef std::bidirectional_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   iterator() : p(nullptr), i(0) {}
+   iterator(Node * p, size_t i) : p(p), i(i) {}
+
+   bool operator == (const iterator & rhs) const { return p == rhs.p && i == rhs.i; }
+   bool operator != (const iterator & rhs) const { return !(*this == rhs);          }
+
+   T & operator * ()  const { return p->at(i);   }
+   T * operator -> () const { return p->slot(i); }
+
+   // the next slot, or the first of the next node
+   iterator & operator ++ ()
+   {
+      if (++i == p->num && p->pNext)
+      {
+         p = p->pNext;
+         i = 0;
+      }
+      return *this;
+   }
+   iterator operator ++ (int)
+   {
+      iterator original = *this;
+      ++*this;
+      return original;
+   }
+
+   // the slot before, or the last of the node before
+   iterator & operator -- ()
+   {
+      if (i == 0)
+      {
+         p = p->pPrev;
+         i = p->num;
+      }
+      --i;
+      return *this;
+   }
+   iterator operator -- (int)
+   {
+      iterator original = *this;
+      --*this;
+      return original;
+   }
+
+private:
+   Node * p;   // the node, or nullptr for end() of an empty list
+   size_t i;   // the slot in that node
+};
+
+/*****************************************
+ * UNROLLED LIST :: NON-DEFAULT constructors
+ * num copies of t, an initializer list, or a range
+ ****************************************/
+template <typename T, size_t K>
+unrolled_list <T, K> :: unrolled_list(size_t num, const T & t) : unrolled_list()
+{
+   for (size_t n = 0; n < num; n++)
+      push_back(t);
+}
+
+template <typename T, size_t K>
+unrolled_list <T, K> :: unrolled_list(const std::initializer_list<T> & il) : unrolled_list()
+{
+   for (const T & t : il)
+      push_back(t);
+}
+
+template <typename T, size_t K>
+template <class Iterator>
+unrolled_list <T, K> :: unrolled_list(Iterator first, Iterator last) : unrolled_list()
+{
+   for (; first != last; ++first)
+      push_back(*first);
+}
+
+/*****************************************
+ * UNROLLED LIST :: COPY constructor
+ * Node for node: the copy is packed just as rhs is
+ ****************************************/
+template <typename T, size_t K>
+unrolled_list <T, K> :: unrolled_list(const unrolled_list & rhs) : unrolled_list()
+{
+   try
+   {
+      for (Node * pSrc = rhs.pHead; pSrc; pSrc = pSrc->pNext)
+      {
+         Node * pNode = linkAfter(pTail);
+         for (size_t i = 0; i < pSrc->num; i++)
+         {
+            new ((void *)pNode->slot(i)) T(pSrc->at(i));
+            pNode->num++;
+            numElements++;
+         }
+      }
+   }
+   catch (...)
+   {
+      clear();
+      throw;
+   }
+}
+
+/*****************************************
+ * UNROLLED LIST :: MOVE constructor
+ * Steal rhs's nodes
+ ****************************************/
+template <typename T, size_t K>
+unrolled_list <T, K> :: unrolled_list(unrolled_list && rhs) noexcept : unrolled_list()
+{
+   swap(rhs);
+}
+
+/*****************************************
+ * UNROLLED LIST :: ASSIGN
+ * Copy into a temporary and swap with it
+ ****************************************/
+template <typename T, size_t K>
+unrolled_list <T, K> & unrolled_list <T, K> :: operator = (const unrolled_list & rhs)
+{
+   if (this != &rhs)
+   {
+      unrolled_list copy(rhs);
+      swap(copy);
+   }
+   return *this;
+}
+
+template <typename T, size_t K>
+unrolled_list <T, K> & unrolled_list <T, K> :: operator = (unrolled_list && rhs) noexcept
+{
+   if (this != &rhs)
+   {
+      clear();
+      swap(rhs);
+   }
+   return *this;
+}
+
+/*****************************************
+ * UNROLLED LIST :: INSERT
+ * Put t before it.  If the node has room, the
+ * slots after it shift up by one.  If it is full,
+ * the upper half moves to a new node first, unless
+ * this is an append to the tail, which just starts
+ * a new node so push_back leaves every node full
+ *     INPUT  : it  where t goes; end() appends
+ *              t   the new element
+ *     OUTPUT : an iterator to the new element
+ ****************************************/
+template <typename T, size_t K>
+typename unrolled_list <T, K> :: iterator
+unrolled_list <T, K> :: insert(iterator it, T && t)
+{
+   Node * pNode = it.p;
+   size_t i = it.i;
+
+   if (pNode == nullptr)
+      pNode = linkAfter(nullptr);                 // the first node
+   else if (pNode->num == K)
+   {
+      if (i == K)
+      {
+         pNode = linkAfter(pNode);                // append past a full node
+         i = 0;
+      }
+      else
+      {
+         Node * pUpper = linkAfter(pNode);
+         moveSlots(pUpper, 0, pNode, K / 2, K - K / 2);
+         if (i > K / 2)
+         {
+            pNode = pUpper;
+            i -= K / 2;
+         }
+      }
+   }
+
+   shiftUp(pNode, i);
+   new ((void *)pNode->slot(i)) T(std::move(t));
+   pNode->num++;
+   numElements++;
+   return iterator(pNode, i);
+}
+
+/*****************************************
+ * UNROLLED LIST :: ERASE
+ * Remove the element at it and shift the rest of
+ * its node down.  An empty node is unlinked; one
+ * under half full takes in its successor if the
+ * two fit in one node
+ *     INPUT  : it  the element to remove
+ *     OUTPUT : an iterator to the element after it
+ ****************************************/
+template <typename T, size_t K>
+typename unrolled_list <T, K> :: iterator
+unrolled_list <T, K> :: erase(iterator it)
+{
+   Node * pNode = it.p;
+   size_t i = it.i;
+   assert(pNode && i < pNode->num);
+
+   pNode->at(i).~T();
+   shiftDown(pNode, i);
+   pNode->num--;
+   numElements--;
+
+   if (pNode->num == 0)
+   {
+      Node * pNext = pNode->pNext;
+      unlink(pNode);
+      return pNext ? iterator(pNext, 0) : end();
+   }
+
+   Node * pNext = pNode->pNext;
+   if (pNext && pNode->num < K / 2 && pNode->num + pNext->num <= K)
+   {
+      moveSlots(pNode, pNode->num, pNext, 0, pNext->num);
+      unlink(pNext);
+   }
+
+   if (i < pNode->num || pNode->pNext == nullptr)
+      return iterator(pNode, i);
+   return iterator(pNode->pNext, 0);
+}
+
+/*****************************************
+ * UNROLLED LIST :: CLEAR
+ * Destroy every element and free every node
+ ****************************************/
+template <typename T, size_t K>
+void unrolled_list <T, K> :: clear()
+{
+   while (pHead)
+   {
+      Node * pNode = pHead;
+      pHead = pHead->pNext;
+      for (size_t i = 0; i < pNode->num; i++)
+         pNode->at(i).~T();
+      delete pNode;
+   }
+   pTail = nullptr;
+   numElements = 0;
+}
+
+/*****************************************
+ * UNROLLED LIST :: LINK AFTER
+ * A new, empty node after pNode, or at the front
+ * if pNode is nullptr
+ ****************************************/
+template <typename T, size_t K>
+typename unrolled_list <T, K> :: Node *
+unrolled_list <T, K> :: linkAfter(Node * pNode)
+{
+   Node * pNew = new Node;
+   pNew->pPrev = pNode;
+   pNew->pNext = pNode ? pNode->pNext : pHead;
+   if (pNew->pNext)
+      pNew->pNext->pPrev = pNew;
+   else
+      pTail = pNew;
+   if (pNode)
+      pNode->pNext = pNew;
+   else
+      pHead = pNew;
+   return pNew;
+}
+
+/*****************************************
+ * UNROLLED LIST :: UNLINK
+ * Take an empty node off the chain and free it
+ ****************************************/
+template <typename T, size_t K>
+void unrolled_list <T, K> :: unlink(Node * pNode)
+{
+   assert(pNode->num == 0);
+   if (pNode->pPrev)
+      pNode->pPrev->pNext = pNode->pNext;
+   else
+      pHead = pNode->pNext;
+   if (pNode->pNext)
+      pNode->pNext->pPrev = pNode->pPrev;
+   else
+      pTail = pNode->pPrev;
+   delete pNode;
+}
+
+/*****************************************
+ * UNROLLED LIST :: MOVE SLOTS
+ * Move the last num elements of pSrc, starting at
+ * iSrc, to the empty slots of pDest at iDest
+ ****************************************/
+template <typename T, size_t K>
+void unrolled_list <T, K> :: moveSlots(Node * pDest, size_t iDest,
+                                       Node * pSrc, size_t iSrc, size_t num)
+{
+   assert(iDest == pDest->num && iSrc + num == pSrc->num);
+   for (size_t n = 0; n < num; n++)
+   {
+      new ((void *)pDest->slot(iDest + n)) T(std::move(pSrc->at(iSrc + n)));
+      pSrc->at(iSrc + n).~T();
+   }
+   pDest->num += num;
+   pSrc->num -= num;
+}
+
+/*****************************************
+ * UNROLLED LIST :: SHIFT UP / SHIFT DOWN
+ * Open an empty slot at i by moving [i, num) up
+ * one, or close the empty slot at i by moving
+ * (i, num) down one.  num is left for the caller
+ ****************************************/
+template <typename T, size_t K>
+void unrolled_list <T, K> :: shiftUp(Node * pNode, size_t i)
+{
+   assert(pNode->num < K);
+   for (size_t j = pNode->num; j > i; j--)
+   {
+      new ((void *)pNode->slot(j)) T(std::move(pNode->at(j - 1)));
+      pNode->at(j - 1).~T();
+   }
+}
+
+template <typename T, size_t K>
+void unrolled_list <T, K> :: shiftDown(Node * pNode, size_t i)
+{
+   for (size_t j = i + 1; j < pNode->num; j++)
+   {
+      new ((void *)pNode->slot(j - 1)) T(std::move(pNode->at(j)));
+      pNode->at(j).~T();
+   }
+}
+
+} // namespace custom
@@ -13,7 +13,11 @@
  *
  *    This will contain the class definition of:
  *        Node         : A class representing a Node
- *    Additionally, it will contain a few functions working on Node
+ *        NodeHeap     : Nodes from new and delete, one at a time
+ *        NodePool     : Nodes carved from slabs, recycled on a free list
+ *    Additionally, it will contain a few functions working on Node.
+ *    copy, assign, insert, remove and clear each take an optional
+ *    pool; without one, every node is its own new and delete.
  * Author
  *    <Jacob Johnson and Tyler Elms>
  ************************************************************************/
@@ -21,7 +25,10 @@
 #pragma once
 
 #include <cassert>     // for ASSERT
+#include <cstddef>     // for size_t
 #include <iostream>    // for NULL
+#include <new>         // for placement new
+#include <utility>     // for std::move and std::forward
 
 /*************************************************
  * NODE
@@ -34,64 +41,215 @@ template <class T>
 class Node
 {
 public:
-    Node()
+    Node()                 : data(),                pNext(nullptr), pPrev(nullptr) {}
+    Node(const T &  data)  : data(data),            pNext(nullptr), pPrev(nullptr) {}
+    Node(      T && data)  : data(std::move(data)), pNext(nullptr), pPrev(nullptr) {}
+
+    T data;
+    Node<T>* pNext;
+    Node<T>* pPrev;
+};
+
+
+/*************************************************
+ * NODE HEAP
+ * Where nodes come from when no pool is given:
+ * one new and one delete per node
+ *************************************************/
+template <class T>
+struct NodeHeap
+{
+    template <class ... Args>
+    Node<T>* create(Args&& ... args)
+    {
+        return new Node<T>(std::forward<Args>(args)...);
+    }
+    void destroy(Node<T>* p)
+    {
+        delete p;
+    }
+};
+
+/*************************************************
+ * NODE POOL
+ * Nodes for one element type, carved out of slabs
+ * that double from 64 nodes up to 64K.  A destroyed
+ * node goes on a free list and is the next one
+ * created; fresh nodes are handed out in address
+ * order, so a chain built by copy sits in a few
+ * contiguous slabs rather than all over the heap.
+ * Slabs are only freed all together, by release or
+ * the destructor, and every node must be destroyed
+ * (by remove or clear) before then
+ *************************************************/
+template <class T>
+class NodePool
+{
+public:
+    NodePool() : pSlabs(nullptr), pFree(nullptr), pFresh(nullptr),
+                 numFresh(0), numNextSlab(firstSlab), numCapacity(0), numSlabs(0) {}
+    NodePool(const NodePool& rhs) = delete;
+    NodePool& operator=(const NodePool& rhs) = delete;
+    ~NodePool() { release(); }
+
+    template <class ... Args>
+    Node<T>* create(Args&& ... args)
     {
-       pPrev = pNext = this;
+        Slot* p = take();
+        try
+        {
+            return new ((void*)p) Node<T>(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            giveBack(p);
+            throw;
+        }
     }
-    Node(const T &  data)
+    void destroy(Node<T>* p)
     {
-        this->data = data;
+        p->~Node<T>();
+        giveBack(reinterpret_cast<Slot*>(p));
     }
-    Node(      T && data)
+
+    // free every slab at once
+    void release()
     {
-        this->data = std::move(data);
+        while (pSlabs)
+        {
+            Slot* pSlab = pSlabs;
+            pSlabs = pSlabs->pNext;
+            delete [] pSlab;
+        }
+        pFree = pFresh = nullptr;
+        numFresh = numCapacity = numSlabs = 0;
+        numNextSlab = firstSlab;
     }
 
-    T data;
-    Node<T>* pNext;
-    Node<T>* pPrev;
+    size_t capacity() const { return numCapacity; }
+    size_t slabs()    const { return numSlabs;    }
+
+private:
+    static const size_t firstSlab = 64;
+    static const size_t maxSlab = 65536;
+
+    // a node's storage, or a link while it is free
+    union Slot
+    {
+        Slot* pNext;
+        alignas(Node<T>) unsigned char node[sizeof(Node<T>)];
+    };
+
+    Slot* take()
+    {
+        if (pFree)
+        {
+            Slot* p = pFree;
+            pFree = pFree->pNext;
+            return p;
+        }
+        if (numFresh == 0)
+            grow();
+        numFresh--;
+        return pFresh++;
+    }
+    void giveBack(Slot* p)
+    {
+        p->pNext = pFree;
+        pFree = p;
+    }
+
+    // the first slot of every slab links it to the slab before
+    void grow()
+    {
+        Slot* pSlab = new Slot[numNextSlab];
+        pSlab->pNext = pSlabs;
+        pSlabs = pSlab;
+        pFresh = pSlab + 1;
+        numFresh = numNextSlab - 1;
+        numCapacity += numFresh;
+        numSlabs++;
+        if (numNextSlab < maxSlab)
+            numNextSlab *= 2;
+    }
+
+    Slot* pSlabs;        // the newest slab, linked to the older ones
+    Slot* pFree;         // destroyed nodes, ready to be reused
+    Slot* pFresh;        // the next never-used slot of the newest slab
+    size_t numFresh;     // never-used slots left in the newest slab
+    size_t numNextSlab;  // slots in the next slab
+    size_t numCapacity;  // nodes all the slabs can hold
+    size_t numSlabs;     // slabs allocated
 };
 
+/*****************************************************
+ * CLEAR
+ * Free all the data currently in the linked list
+ *   INPUT   : pointer to the head of the linked list
+ *             the pool the nodes go back to
+ *   OUTPUT  : pHead set to NULL
+ *   COST    : O(n)
+ ****************************************************/
+template <class T, class Pool>
+inline void clear(Node<T>*& pHead, Pool& pool)
+{
+    while (pHead)
+    {
+        Node<T>* temp = pHead;
+        pHead = pHead->pNext;
+        pool.destroy(temp);
+    }
+}
+
+template <class T>
+inline void clear(Node<T>*& pHead)
+{
+    NodeHeap<T> heap;
+    clear(pHead, heap);
+}
 
 /***********************************************
  * COPY
  * Copy the list from the pSource and return
  * the new list
  *   INPUT  : the list to be copied
+ *            the pool the new nodes come from
  *   OUTPUT : return the new list
  *   COST   : O(n)
  **********************************************/
-template <class T>
-inline Node<T>* copy(const Node<T>* pSource)
+template <class T, class Pool>
+inline Node<T>* copy(const Node<T>* pSource, Pool& pool)
 {
-    if (!pSource)
-    {
-        return nullptr;
-    }
+    Node<T>* pHead = nullptr;
+    Node<T>* pTail = nullptr;
 
-    Node<T>* pNewHead = new Node<T>;
-    Node<T>* pCurrentSource = const_cast<Node<T>*>(pSource);
-    Node<T>* pCurrentNew = pNewHead;
-
-    while (pCurrentSource)
+    try
     {
-        pCurrentNew->data = pCurrentSource->data;
-
-        if (pCurrentSource->pNext)
+        for (const Node<T>* p = pSource; p; p = p->pNext)
         {
-            pCurrentNew->pNext = new Node<T>;
-            pCurrentNew->pNext->pPrev = pCurrentNew;
-            pCurrentNew = pCurrentNew->pNext;
-        }
-        else
-        {
-            pCurrentNew->pNext = nullptr;
+            Node<T>* pNew = pool.create(p->data);
+            pNew->pPrev = pTail;
+            if (pTail)
+                pTail->pNext = pNew;
+            else
+                pHead = pNew;
+            pTail = pNew;
         }
-
-        pCurrentSource = pCurrentSource->pNext;
     }
+    catch (...)
+    {
+        clear(pHead, pool);
+        throw;
+    }
+
+    return pHead;
+}
 
-    return pNewHead;
+template <class T>
+inline Node<T>* copy(const Node<T>* pSource)
+{
+    NodeHeap<T> heap;
+    return copy(pSource, heap);
 }
 
 /***********************************************
@@ -99,61 +257,55 @@ inline Node<T>* copy(const Node<T>* pSource)
  * Copy the values from pSource into pDestination
  * reusing the nodes already created in pDestination if possible.
  *   INPUT  : the list to be copied
+ *            the pool new nodes come from and spare ones go back to
  *   OUTPUT : return the new list
  *   COST   : O(n)
  **********************************************/
-template <class T>
-inline void assign(Node<T>*& pDestination, const Node<T>* pSource)
+template <class T, class Pool>
+inline void assign(Node<T>*& pDestination, const Node<T>* pSource, Pool& pool)
 {
-    if (!pSource)
-    {
-        while (pDestination)
-        {
-            Node<T>* temp = pDestination;
-            pDestination = pDestination->pNext;
-            delete temp;
-        }
-        return;
-    }
-
-    Node<T>* pDestCurrent = pDestination;
     const Node<T>* pSourceCurrent = pSource;
+    Node<T>* pDestCurrent = pDestination;
+    Node<T>* pDestLast = nullptr;
 
-    while (pSourceCurrent)
+    // assign onto the nodes both lists have
+    while (pSourceCurrent && pDestCurrent)
     {
-        if (pDestCurrent)
-        {
-            pDestCurrent->data = pSourceCurrent->data;
-        }
-        else
-        {
-            pDestCurrent = new Node<T>;
-            pDestCurrent->data = pSourceCurrent->data;
-
-            if (pDestination)
-            {
-                pDestCurrent->pPrev = pDestination->pPrev;
-                pDestination->pPrev->pNext = pDestCurrent;
-                pDestination->pPrev = pDestCurrent;
-            }
-            else
-            {
-                pDestination = pDestCurrent;
-            }
-        }
-
+        pDestCurrent->data = pSourceCurrent->data;
+        pDestLast = pDestCurrent;
         pDestCurrent = pDestCurrent->pNext;
         pSourceCurrent = pSourceCurrent->pNext;
     }
 
-    while (pDestCurrent)
+    // the source is longer: copy the rest onto the end
+    if (pSourceCurrent)
     {
-        Node<T>* temp = pDestCurrent;
-        pDestCurrent = pDestCurrent->pNext;
-        delete temp;
+        Node<T>* pRest = copy(pSourceCurrent, pool);
+        pRest->pPrev = pDestLast;
+        if (pDestLast)
+            pDestLast->pNext = pRest;
+        else
+            pDestination = pRest;
+    }
+
+    // the destination is longer: free the rest
+    else if (pDestCurrent)
+    {
+        if (pDestLast)
+            pDestLast->pNext = nullptr;
+        else
+            pDestination = nullptr;
+        clear(pDestCurrent, pool);
     }
 }
 
+template <class T>
+inline void assign(Node<T>*& pDestination, const Node<T>* pSource)
+{
+    NodeHeap<T> heap;
+    assign(pDestination, pSource, heap);
+}
+
 /***********************************************
  * SWAP
  * Swap the list from LHS to RHS
@@ -181,12 +333,13 @@ inline void swap(Node<T>*& pLHS, Node<T>*& pRHS)
  * REMOVE
  * Remove the node pSource in the linked list
  *   INPUT  : pRemove - the node to be removed
+ *            the pool the node goes back to
  *   OUTPUT : Returns a pointer to the parent node
- *            of the removed node (or nullptr if pRemove is the head node)
+ *            of the removed node (or the child if pRemove is the head node)
  *   COST   : O(1)
  **********************************************/
-template <class T>
-inline Node<T>* remove(const Node<T>* pRemove)
+template <class T, class Pool>
+inline Node<T>* remove(const Node<T>* pRemove, Pool& pool)
 {
     if (!pRemove)
     {
@@ -200,20 +353,21 @@ inline Node<T>* remove(const Node<T>* pRemove)
     {
         pPrevNode->pNext = pNextNode;
     }
-    
+
     if (pNextNode)
     {
         pNextNode->pPrev = pPrevNode;
     }
 
-    if (pRemove == pPrevNode)
-    {
-        return nullptr;
-    }
-    else
-    {
-        return pPrevNode;
-    }
+    pool.destroy(const_cast<Node<T>*>(pRemove));
+    return pPrevNode ? pPrevNode : pNextNode;
+}
+
+template <class T>
+inline Node<T>* remove(const Node<T>* pRemove)
+{
+    NodeHeap<T> heap;
+    return remove(pRemove, heap);
 }
 
 
@@ -224,20 +378,18 @@ inline Node<T>* remove(const Node<T>* pRemove)
  *   INPUT   : t - the value to be used for the new node
  *             pCurrent - a pointer to the node before which
  *                we will be inserting the new node
+ *             the pool the new node comes from
  *             after - whether we will be inserting after
  *   OUTPUT  : return the newly inserted item
  *   COST    : O(1)
  **********************************************/
-template <class T>
-inline Node<T>* insert(Node<T>* pCurrent, const T& t, bool after = false)
+template <class T, class Pool>
+inline Node<T>* insert(Node<T>* pCurrent, const T& t, Pool& pool, bool after = false)
 {
-    Node<T>* pNewNode = new Node<T>;
-    pNewNode->data = t;
+    Node<T>* pNewNode = pool.create(t);
 
     if (!pCurrent)
     {
-        pNewNode->pNext = pNewNode;
-        pNewNode->pPrev = pNewNode;
         return pNewNode;
     }
 
@@ -264,14 +416,16 @@ inline Node<T>* insert(Node<T>* pCurrent, const T& t, bool after = false)
         }
 
         pCurrent->pPrev = pNewNode;
-
-        if (pCurrent == pCurrent->pPrev)
-        {
-            return pNewNode;
-        }
     }
 
-    return pCurrent->pPrev;
+    return pNewNode;
+}
+
+template <class T>
+inline Node<T>* insert(Node<T>* pCurrent, const T& t, bool after = false)
+{
+    NodeHeap<T> heap;
+    return insert(pCurrent, t, heap, after);
 }
 
 /******************************************************
@@ -319,20 +473,3 @@ inline std::ostream& operator<<(std::ostream& out, const Node<T>* pHead)
     return out;
 }
 
-/*****************************************************
- * CLEAR
- * Free all the data currently in the linked list
- *   INPUT   : pointer to the head of the linked list
- *   OUTPUT  : pHead set to NULL
- *   COST    : O(n)
- ****************************************************/
-template <class T>
-inline void clear(Node<T>*& pHead)
-{
-    while (pHead)
-    {
-        Node<T>* temp = pHead;
-        pHead = pHead->pNext;
-        delete temp;
-    }
-}
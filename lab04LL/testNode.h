@@ -65,6 +65,15 @@ public:
       test_size_empty();
       test_size_standard();
       test_size_standardMiddle();
+
+      // Pool
+      test_pool_copyContiguous();
+      test_pool_growsBySlabs();
+      test_pool_clearRecycles();
+      test_pool_removeRecycles();
+      test_pool_assignSmallToBig();
+      test_pool_assignBigToSmall();
+      test_pool_release();
       
       report("Node");
    }
@@ -1372,6 +1381,192 @@ public:
    }  // teardown
 
 
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // a copy from a pool lays its nodes out one after the other
+   void test_pool_copyContiguous()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      NodePool <Spy> pool;
+      Node <Spy>* pDes = nullptr;
+      Spy::reset();
+      // exercise
+      pDes = copy(p11, pool);
+      // verify
+      assertUnit(Spy::numCopy() == 3);      // copy [11][26][31]
+      assertUnit(Spy::numAlloc() == 3);     // the copies' own ints, no nodes
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(pool.slabs() == 1);
+      assertUnit(pool.capacity() == 63);
+      assertStandardFixture(pDes);
+      if (pDes && pDes->pNext)
+      {
+         assertUnit(pDes->pNext == pDes + 1);
+         assertUnit(pDes->pNext->pNext == pDes + 2);
+      }
+      // teardown
+      teardownStandardFixture(p11);
+      clear(pDes, pool);
+   }
+
+   // the slabs double: 63 + 127 + 255 nodes
+   void test_pool_growsBySlabs()
+   {  // setup
+      NodePool <int> pool;
+      Node <int>* pHead = nullptr;
+      // exercise
+      for (int i = 0; i < 200; i++)
+         pHead = insert(pHead, i, pool);
+      // verify
+      assertUnit(pool.slabs() == 3);
+      assertUnit(pool.capacity() == 63 + 127 + 255);
+      assertUnit(size(pHead) == 200);
+      assertUnit(pHead && pHead->data == 199);
+      // teardown
+      clear(pHead, pool);
+   }
+
+   // clear gives the nodes back and the next copy reuses them
+   void test_pool_clearRecycles()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      NodePool <Spy> pool;
+      Node <Spy>* pDes = copy(p11, pool);
+      Node <Spy>* pFirst = pDes;
+      Spy::reset();
+      // exercise
+      clear(pDes, pool);
+      // verify
+      assertUnit(Spy::numDestructor() == 3);   // destroy [11][26][31]
+      assertUnit(Spy::numDelete() == 3);       // their ints
+      assertUnit(pDes == nullptr);
+      // exercise
+      pDes = copy(p11, pool);
+      // verify
+      assertUnit(pool.slabs() == 1);
+      assertUnit(pDes == pFirst + 2);          // the last freed comes back first
+      assertStandardFixture(pDes);
+      // teardown
+      teardownStandardFixture(p11);
+      clear(pDes, pool);
+   }
+
+   // a removed node is the next one inserted
+   void test_pool_removeRecycles()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      NodePool <Spy> pool;
+      Node <Spy>* pDes = copy(p11, pool);
+      Node <Spy>* pMiddle = pDes->pNext;
+      Node <Spy>* pReturn = nullptr;
+      Spy::reset();
+      // exercise
+      pReturn = remove(pMiddle, pool);
+      pReturn = insert(pReturn, Spy(26), pool, true /*after*/);
+      // verify
+      assertUnit(Spy::numDestructor() == 2);   // the old [26] and the temporary
+      assertUnit(pReturn == pMiddle);
+      assertStandardFixture(pDes);
+      // teardown
+      teardownStandardFixture(p11);
+      clear(pDes, pool);
+   }
+
+   // the node a shorter source does not need goes back to the pool
+   void test_pool_assignSmallToBig()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      NodePool <Spy> pool;
+      Node <Spy>* pDes = copy(p11, pool);
+      Node <Spy>* pThird = pDes->pNext->pNext;
+      Node <Spy>* pSrc = p26;
+      p11->pNext = nullptr;
+      p26->pPrev = nullptr;
+      Spy::reset();
+      // exercise
+      assign(pDes, pSrc, pool);
+      // verify
+      assertUnit(Spy::numAssign() == 2);       // assign [26][31]
+      assertUnit(Spy::numDestructor() == 1);   // destroy the third
+      assertUnit(size(pDes) == 2);
+      assertUnit(pool.create(Spy(99)) == pThird);
+      // teardown
+      pool.destroy(pThird);
+      clear(p11);
+      clear(pSrc);
+      clear(pDes, pool);
+   }
+
+   // the node a longer source needs comes from the pool
+   void test_pool_assignBigToSmall()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      NodePool <Spy> pool;
+      Node <Spy>* pDes = insert((Node <Spy>*)nullptr, Spy(67), pool);
+      Spy::reset();
+      // exercise
+      assign(pDes, p11, pool);
+      // verify
+      assertUnit(Spy::numAssign() == 1);       // assign [11] onto [67]
+      assertUnit(Spy::numCopy() == 2);         // copy-create [26][31]
+      assertUnit(pool.slabs() == 1);
+      assertStandardFixture(pDes);
+      if (pDes && pDes->pNext)
+         assertUnit(pDes->pNext == pDes + 1);
+      // teardown
+      teardownStandardFixture(p11);
+      clear(pDes, pool);
+   }
+
+   // release frees the slabs all together
+   void test_pool_release()
+   {  // setup
+      NodePool <int> pool;
+      Node <int>* pHead = nullptr;
+      for (int i = 0; i < 100; i++)
+         pHead = insert(pHead, i, pool);
+      clear(pHead, pool);
+      // exercise
+      pool.release();
+      // verify
+      assertUnit(pool.slabs() == 0);
+      assertUnit(pool.capacity() == 0);
+      // exercise
+      pHead = insert(pHead, 26, pool);
+      // verify
+      assertUnit(pool.slabs() == 1);
+      assertUnit(pHead && pHead->data == 26);
+      // teardown
+      clear(pHead, pool);
+   }
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *    +----+   +----+   +----+